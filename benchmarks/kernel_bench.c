@@ -0,0 +1,410 @@
+/**
+ ******************************************************************************
+ * File           : kernel_bench.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Linux host (POSIX port)
+ * Brief          : Kernel micro-benchmarks: context switch round trip, tick
+ *                  ISR and scheduler pass versus number of tasks, task
+ *                  create/delete, ISR wake-up latency, with semaphores
+ *                  and with task notifications, and the cost of a trace
+ *                  record when TRACE_RECORDER is enabled. The results are
+ *                  printed as JSON, built and run by run_benchmarks.sh.
+ ******************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+
+#include <LIB/std_types.h>
+#include <Kernel/kernel_cfg.h>
+#include <Kernel/kernel_interface.h>
+#include <Kernel/port/port.h>
+#include <Kernel/Task.h>
+#include <Kernel/Semaphore.h>
+#include <Kernel/Notify.h>
+#include <Kernel/Trace.h>
+
+
+#ifndef BENCH_COMMIT
+#define BENCH_COMMIT                "unknown"
+#endif
+
+#ifndef BENCH_SCHEDULER
+#define BENCH_SCHEDULER             "unknown"
+#endif
+
+// Round-robin only switches on the tick, fewer rounds keep the run short
+#if SCHEDULE_ALGORITHM == ROUND_ROBIN
+#define SWITCH_ROUNDS               200
+#else
+#define SWITCH_ROUNDS               20000
+#endif
+
+#define TICK_CALLS                  5000
+#define SCHEDULER_PASSES            5000
+#define CREATE_ROUNDS               2000
+#define ISR_SAMPLES                 500
+#define ISR_PERIOD_NS               1000000
+#define TRACE_BATCHES               5000
+#define TRACE_BATCH_RECORDS         100         // Records timed together, one clock read costs more than a record
+
+#define MAX_SAMPLES                 20000
+#define FILLER_STACK_SIZE           256
+
+#define RUNNER_PRIORITY             (MAX_PRIORITIES - 2)
+#define FILLER_PRIORITY             (MAX_PRIORITIES - 1)
+
+
+static uint32 Samples[MAX_SAMPLES];
+static uint32 SamplesCount;
+static boolean FirstResult = TRUE;
+
+static Semaphore_t Ping, Pong, Never, IsrSemaphore;
+static Task_Handler_t Runner;
+static volatile uint64 IsrTime;
+static volatile boolean IsrNotify;
+static timer_t IsrTimer;
+
+
+// Host monotonic time in nanoseconds, async-signal-safe
+static uint64 now(void)
+{
+    struct timespec time;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (uint64)time.tv_sec * 1000000000ULL + (uint64)time.tv_nsec;
+}
+
+static void addSample(uint64 nanoSec)
+{
+    if (SamplesCount < MAX_SAMPLES)
+        Samples[SamplesCount++] = (nanoSec > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32)nanoSec;
+}
+
+static int compareSamples(const void *a, const void *b)
+{
+    uint32 x = *(const uint32*)a, y = *(const uint32*)b;
+
+    return (x > y) - (x < y);
+}
+
+
+// Print the summary of the collected samples as one JSON result, parameterName may be NULL
+static void report(const char *name, const char *parameterName, uint32 parameter)
+{
+    uint64 sum = 0;
+
+    // libc calls are not async-signal-safe, keep the kernel signals out
+    DISABLE_INTERRUPTS();
+
+    qsort(Samples, SamplesCount, sizeof(Samples[0]), &compareSamples);
+
+    for (uint32 i = 0; i < SamplesCount; i++)
+        sum += Samples[i];
+
+    printf("%s\n    {\"name\": \"%s\", ", FirstResult ? "" : ",", name);
+
+    if (parameterName != NULL)
+        printf("\"%s\": %u, ", parameterName, parameter);
+
+    printf("\"samples\": %u, \"min\": %u, \"median\": %u, \"p99\": %u, \"max\": %u, \"mean\": %llu}",
+           SamplesCount, Samples[0], Samples[SamplesCount / 2], Samples[(SamplesCount * 99) / 100],
+           Samples[SamplesCount - 1], (unsigned long long)(sum / SamplesCount));
+
+    fflush(stdout);
+    FirstResult  = FALSE;
+    SamplesCount = 0;
+
+    ENABLE_INTERRUPTS();
+}
+
+
+// Tasks standing by in the kernel structures while the benchmarks run
+static void blockedFiller(void)
+{
+    while (1)
+        (void)os_semaphoreTake(&Never, OS_WAIT_FOREVER);
+}
+
+static void delayedFiller(void)
+{
+    while (1)
+        os_delay(0x40000000);
+}
+
+static void pongTask(void)
+{
+    while (1)
+    {
+        (void)os_semaphoreTake(&Ping, OS_WAIT_FOREVER);
+        (void)os_semaphoreGive(&Pong);
+    }
+}
+
+static void notifyPongTask(void)
+{
+    while (1)
+    {
+        (void)os_notifyTake(TRUE, OS_WAIT_FOREVER);
+        (void)os_notifyGive(Runner);
+    }
+}
+
+
+// Create count filler tasks and let them block, they run first at their higher priority
+static void createFillers(Task_Handler_t *fillers, uint32 count, osFunc_t filler)
+{
+    for (uint32 i = 0; i < count; i++)
+        (void)OS_createTask(&fillers[i], filler, "FILLER", FILLER_PRIORITY, FILLER_STACK_SIZE);
+
+    os_delay(2);
+}
+
+static void deleteFillers(Task_Handler_t *fillers, uint32 count)
+{
+    for (uint32 i = 0; i < count; i++)
+        os_deleteTask(fillers[i]);
+}
+
+
+// Give and take a semaphore pair with a task of the same priority, two context switches per round
+static void benchContextSwitch(void)
+{
+    Task_Handler_t pong;
+
+    (void)OS_createTask(&pong, &pongTask, "PONG", RUNNER_PRIORITY, FILLER_STACK_SIZE);
+
+    for (uint32 i = 0; i < SWITCH_ROUNDS; i++)
+    {
+        uint64 start = now();
+
+        (void)os_semaphoreGive(&Ping);
+        (void)os_semaphoreTake(&Pong, OS_WAIT_FOREVER);
+
+        addSample(now() - start);
+    }
+
+    os_deleteTask(pong);
+
+    report("context_switch_round_trip", NULL, 0);
+}
+
+
+// Same round trip with task notifications instead of semaphores
+static void benchNotifySwitch(void)
+{
+    Task_Handler_t pong;
+
+    (void)OS_createTask(&pong, &notifyPongTask, "PONG", RUNNER_PRIORITY, FILLER_STACK_SIZE);
+
+    for (uint32 i = 0; i < SWITCH_ROUNDS; i++)
+    {
+        uint64 start = now();
+
+        (void)os_notifyGive(pong);
+        (void)os_notifyTake(TRUE, OS_WAIT_FOREVER);
+
+        addSample(now() - start);
+    }
+
+    os_deleteTask(pong);
+
+    report("notify_round_trip", NULL, 0);
+}
+
+
+// Cost of the tick handler with tasks waiting in the delay list
+static void benchTick(uint32 delayedTasks)
+{
+    Task_Handler_t fillers[MAX_TASKS];
+
+    createFillers(fillers, delayedTasks, &delayedFiller);
+
+    for (uint32 i = 0; i < TICK_CALLS; i++)
+    {
+        uint64 start;
+
+        DISABLE_INTERRUPTS();
+        start = now();
+        SysTick_Handler();
+        addSample(now() - start);
+        ENABLE_INTERRUPTS();	// The PendSV raised by the tick runs here
+    }
+
+    deleteFillers(fillers, delayedTasks);
+
+    report("tick_isr", "delayed_tasks", delayedTasks);
+}
+
+
+// Cost of a PendSV selecting the running task again with blocked tasks around
+static void benchSchedulerPass(uint32 blockedTasks)
+{
+    Task_Handler_t fillers[MAX_TASKS];
+
+    createFillers(fillers, blockedTasks, &blockedFiller);
+
+    for (uint32 i = 0; i < SCHEDULER_PASSES; i++)
+    {
+        uint64 start;
+
+        DISABLE_INTERRUPTS();
+        start = now();
+        enablePENDSV();
+        ENABLE_INTERRUPTS();
+        addSample(now() - start);
+    }
+
+    deleteFillers(fillers, blockedTasks);
+
+    report("scheduler_pass", "blocked_tasks", blockedTasks);
+}
+
+
+static void benchCreateDelete(void)
+{
+    static uint32 deleteSamples[CREATE_ROUNDS];
+
+    for (uint32 i = 0; i < CREATE_ROUNDS; i++)
+    {
+        Task_Handler_t task;
+        uint64 start = now(), created, deleted;
+
+        // Below the runner, so it never runs before it is deleted
+        (void)OS_createTask(&task, &delayedFiller, "TEMP", 1, FILLER_STACK_SIZE);
+        created = now();
+        os_deleteTask(task);
+        deleted = now();
+
+        addSample(created - start);
+        deleteSamples[i] = (uint32)(deleted - created);
+    }
+
+    report("task_create", NULL, 0);
+
+    for (uint32 i = 0; i < CREATE_ROUNDS; i++)
+        addSample(deleteSamples[i]);
+
+    report("task_delete", NULL, 0);
+}
+
+
+#if TRACE_RECORDER == ENABLED
+
+// Cost of one trace record, from the average of a batch
+static void benchTraceRecord(void)
+{
+    for (uint32 i = 0; i < TRACE_BATCHES; i++)
+    {
+        uint64 start = now();
+
+        for (uint32 j = 0; j < TRACE_BATCH_RECORDS; j++)
+            traceRecord(TRACE_TASK_RESUME, 0, (uint16)j);
+
+        addSample((now() - start) / TRACE_BATCH_RECORDS);
+    }
+
+    report("trace_record", NULL, 0);
+}
+
+#endif
+
+
+static void isrHandler(void)
+{
+    IsrTime = now();
+
+    if (IsrNotify)
+        (void)os_notifyGiveFromISR(Runner);
+    else
+        (void)os_semaphoreGiveFromISR(&IsrSemaphore);
+}
+
+// Time from the give in an ISR to the waiting task running, through a semaphore or a notification
+static void benchIsrLatency(boolean notify)
+{
+    struct itimerspec period = {{0, ISR_PERIOD_NS}, {0, ISR_PERIOD_NS}};
+    struct itimerspec stop = {{0, 0}, {0, 0}};
+
+    IsrNotify = notify;
+    (void)timer_settime(IsrTimer, 0, &period, NULL);
+
+    for (uint32 i = 0; i < ISR_SAMPLES; i++)
+    {
+        if (notify)
+            (void)os_notifyTake(TRUE, OS_WAIT_FOREVER);
+        else
+            (void)os_semaphoreTake(&IsrSemaphore, OS_WAIT_FOREVER);
+
+        addSample(now() - IsrTime);
+    }
+
+    (void)timer_settime(IsrTimer, 0, &stop, NULL);
+
+    report(notify ? "isr_notify_latency" : "isr_wake_latency", NULL, 0);
+}
+
+
+static void runnerTask(void)
+{
+    static const uint32 taskCounts[] = {0, 8, 32};
+
+    DISABLE_INTERRUPTS();
+    printf("{\n  \"suite\": \"kernel_bench\",\n  \"port\": \"POSIX_GCC_PORT\",\n  \"scheduler\": \"%s\",\n"
+           "  \"commit\": \"%s\",\n  \"unit\": \"ns\",\n  \"results\": [", BENCH_SCHEDULER, BENCH_COMMIT);
+    ENABLE_INTERRUPTS();
+
+    benchContextSwitch();
+    benchNotifySwitch();
+
+    for (uint32 i = 0; i < sizeof(taskCounts) / sizeof(taskCounts[0]); i++)
+        if (taskCounts[i] < MAX_TASKS - 2)
+            benchTick(taskCounts[i]);
+
+    for (uint32 i = 0; i < sizeof(taskCounts) / sizeof(taskCounts[0]); i++)
+        if (taskCounts[i] < MAX_TASKS - 2)
+            benchSchedulerPass(taskCounts[i]);
+
+    benchCreateDelete();
+    benchIsrLatency(FALSE);
+    benchIsrLatency(TRUE);
+
+#if TRACE_RECORDER == ENABLED
+    benchTraceRecord();
+#endif
+
+    DISABLE_INTERRUPTS();
+    printf("\n  ]\n}\n");
+    fflush(stdout);
+    exit(0);
+}
+
+
+int main(void)
+{
+    struct sigevent event = {0};
+
+    os_init();
+
+    (void)os_semaphoreCreate(&Ping, 0, 1);
+    (void)os_semaphoreCreate(&Pong, 0, 1);
+    (void)os_semaphoreCreate(&Never, 0, 1);
+    (void)os_semaphoreCreate(&IsrSemaphore, 0, 1);
+
+    // The ISR latency interrupt, a real-time signal routed like the kernel signals
+    installInterruptHandler(SIGRTMIN, &isrHandler);
+
+    event.sigev_notify = SIGEV_SIGNAL;
+    event.sigev_signo  = SIGRTMIN;
+    (void)timer_create(CLOCK_MONOTONIC, &event, &IsrTimer);
+
+    (void)OS_createTask(&Runner, &runnerTask, "RUNNER", RUNNER_PRIORITY, 1024);
+
+    os_start();
+
+    return 0;
+}
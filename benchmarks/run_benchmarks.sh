@@ -0,0 +1,42 @@
+#!/bin/sh
+#
+# File           : run_benchmarks.sh
+# Author         : Ibrahim Diab
+# Target         : Linux host (POSIX port)
+# Brief          : Build the kernel with the POSIX port and the micro-benchmarks
+#                  of kernel_bench.c, run them and print the results as JSON.
+#
+# Usage: benchmarks/run_benchmarks.sh [SCHEDULE_ALGORITHM] > results.json
+#        SCHEDULE_ALGORITHM is PRIORITY_PREEMPTIVE (default), ROUND_ROBIN or EDF,
+#        CC and CFLAGS override the compiler and its flags, TRACE_RECORDER=ENABLED
+#        adds the cost of a trace record (and of the recording to the others).
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+ALGORITHM=${1:-PRIORITY_PREEMPTIVE}
+BUILD=$(mktemp -d)
+trap 'rm -rf "$BUILD"' EXIT
+
+# Same layout as for any other port (port/POSIX_GCC_PORT/README.txt)
+cp -r "$ROOT/kernel" "$BUILD/"
+cp -r "$ROOT/port/POSIX_GCC_PORT/Inc/Kernel/port" "$BUILD/kernel/Inc/Kernel/port"
+mkdir -p "$BUILD/kernel/Src/Kernel/kernel_port"
+cp -r "$ROOT/port/POSIX_GCC_PORT/Src/Kernel_port/"* "$BUILD/kernel/Src/Kernel/kernel_port/"
+ln -s Kernel "$BUILD/kernel/Inc/kernel"
+
+# Room for the filler tasks of the scaling benchmarks
+sed -i -e "s/^#define SCHEDULE_ALGORITHM .*/#define SCHEDULE_ALGORITHM          $ALGORITHM/" \
+       -e "s/^#define MAX_TASKS .*/#define MAX_TASKS                   40/" \
+       -e "s/^#define APP_STACK_SIZE .*/#define APP_STACK_SIZE              65536/" \
+       -e "s/^#define TRACE_RECORDER .*/#define TRACE_RECORDER              ${TRACE_RECORDER:-DISABLED}/" \
+       "$BUILD/kernel/Inc/Kernel/kernel_cfg.h"
+
+COMMIT=$(git -C "$ROOT" rev-parse --short HEAD 2>/dev/null || echo unknown)
+
+cd "$BUILD"
+${CC:-gcc} -std=gnu99 ${CFLAGS:--O2} -Wall -Wextra -Ikernel/Src -Ikernel/Inc \
+    -DBENCH_COMMIT="\"$COMMIT\"" -DBENCH_SCHEDULER="\"$ALGORITHM\"" \
+    $(find kernel/Src -name '*.c') "$ROOT/benchmarks/kernel_bench.c" -o kernel_bench -lrt
+
+./kernel_bench
@@ -0,0 +1,109 @@
+/**
+ *******************************************************************************
+ * File           : Coroutine.h
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Including APIs and interfaces of the stackless coroutines.
+ *                  An executor task created by os_init runs every coroutine on
+ *                  its own stack, so a coroutine only costs its control block
+ *                  (COROUTINES enabled).
+ *******************************************************************************
+ */
+#ifndef KERNEL_COROUTINE_H_
+#define KERNEL_COROUTINE_H_
+
+#include "List.h"
+
+
+struct Coroutine_t;
+
+typedef void (*osCoroutineFunc_t)(struct Coroutine_t *co);
+
+
+// Request a coroutine leaves to the executor when it returns
+typedef enum CoroutineRequest_t
+{
+    CO_REQUEST_EXIT = 0,            // Done, also the request of a function returning without a macro
+    CO_REQUEST_YIELD,               // Run again after the other ready coroutines
+    CO_REQUEST_DELAY,               // Run again once SysTick reaches node.value
+    CO_REQUEST_WAIT                 // Run again when notified, or once SysTick reaches node.value
+} CoroutineRequest_t;
+
+
+// State of a coroutine, only changed by the executor and the notifiers
+typedef enum CoroutineState_t
+{
+    CO_STOPPED = 0,                 // Never started or exited
+    CO_READY,                       // In the ready list of the executor
+    CO_RUNNING,                     // Being run by the executor
+    CO_DELAYED,                     // In the delay list of the executor
+    CO_WAITING                      // Waiting for a notification, in the delay list when it has a timeout
+} CoroutineState_t;
+
+
+// Structure representing a stackless coroutine, owned by the application
+typedef struct Coroutine_t
+{
+    osCoroutineFunc_t function;     // Run by the executor until it returns
+    void *argument;                 // Data kept across yields, local variables are lost
+    ListNode_t node;                // Link in the ready or delay list, value = wake tick
+    volatile uint32 notifyValue;    // Bits notified and not received yet
+    uint32 received;                // Bits received by the last OS_CO_WAIT_NOTIFY, 0 after a timeout
+    uint32 resumePoint;             // Line to resume at, 0 at the first run
+    uint8 request;                  // CoroutineRequest_t
+    volatile uint8 state;           // CoroutineState_t
+} Coroutine_t;
+
+
+// Define Enumeration for error codes
+typedef enum {
+    OS_CO_SUCCESS = 0,          // Operation successful
+    OS_CO_INVALID,              // NULL coroutine or function, or never started
+    OS_CO_ACTIVE                // The coroutine is already started
+} OS_CoroutineError_t;
+
+
+/* Body of a coroutine function. Local variables do not survive OS_CO_YIELD, OS_CO_DELAY
+   and OS_CO_WAIT_NOTIFY, keep the state in argument. A function using none of the macros
+   simply runs to completion each time it is started. */
+#define OS_CO_BEGIN(co)                 switch ((co)->resumePoint) { case 0:
+
+#define OS_CO_END(co)                   }
+
+// Leave the coroutine and resume it at the next line once the executor honored the request,
+// one suspending macro per source line
+#define OS_CO_SUSPEND(co, req, ticks)   do { (co)->resumePoint = __LINE__; (co)->request = (req); \
+                                             (co)->node.value = (ticks); return; case __LINE__:; } while (0)
+
+// Let the other ready coroutines run.
+#define OS_CO_YIELD(co)                 OS_CO_SUSPEND(co, CO_REQUEST_YIELD, 0)
+
+// Resume after ticks.
+#define OS_CO_DELAY(co, ticks)          OS_CO_SUSPEND(co, CO_REQUEST_DELAY, ticks)
+
+// Resume when notified or after timeout ticks (OS_WAIT_FOREVER), the bits are in (co)->received.
+#define OS_CO_WAIT_NOTIFY(co, timeout)  OS_CO_SUSPEND(co, CO_REQUEST_WAIT, timeout)
+
+// Stop the coroutine, it may be started again.
+#define OS_CO_EXIT(co)                  return
+
+
+#if COROUTINES == ENABLED
+
+// Initialize a stopped coroutine running function, argument is reachable through co->argument.
+OS_CoroutineError_t os_coroutineInit(Coroutine_t *co, osCoroutineFunc_t function, void *argument);
+
+// Make a stopped coroutine ready, it runs from OS_CO_BEGIN.
+OS_CoroutineError_t os_coroutineStart(Coroutine_t *co);
+
+// Set bits in the notification value of a coroutine, it becomes ready if it waits for them.
+OS_CoroutineError_t os_coroutineNotify(Coroutine_t *co, uint32 bits);
+OS_CoroutineError_t os_coroutineNotifyFromISR(Coroutine_t *co, uint32 bits);
+
+#endif
+
+
+
+
+#endif /* KERNEL_COROUTINE_H_ */
@@ -0,0 +1,68 @@
+/**
+ *******************************************************************************
+ * File           : EventGroup.h
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Including APIs and interfaces of 32-bit event flag groups
+ *******************************************************************************
+ */
+#ifndef KERNEL_EVENTGROUP_H_
+#define KERNEL_EVENTGROUP_H_
+
+#include "List.h"
+
+
+// Wait options, to be ORed
+#define OS_EVENT_WAIT_ANY           0x00    // Released when any of the flags is set
+#define OS_EVENT_WAIT_ALL           0x01    // Released when all of the flags are set
+#define OS_EVENT_CLEAR_ON_EXIT      0x02    // Clear the waited flags when released
+
+
+// Structure representing a group of 32 event flags
+typedef struct EventGroup_t
+{
+    uint32 bits;                    // Current flags
+    List_t waiters;                 // Tasks waiting for flags, highest priority first
+} EventGroup_t;
+
+
+// Define Enumeration for error codes
+typedef enum {
+    OS_EVENT_SUCCESS = 0,   // Operation successful
+    OS_EVENT_INVALID,       // NULL group or no flag to wait for
+    OS_EVENT_TIMEOUT        // The flags were not set in time
+} OS_EventError_t;
+
+
+// Initialize an event group with all flags cleared.
+OS_EventError_t os_eventGroupCreate(EventGroup_t *group);
+
+/* Wait up to timeout ticks for any or all (options) of the flags in bitsToWait.
+ Parameters:
+   - group: Event group to wait on
+   - bitsToWait: Flags to wait for
+   - options: OS_EVENT_WAIT_ANY or OS_EVENT_WAIT_ALL, optionally ORed with OS_EVENT_CLEAR_ON_EXIT
+   - timeout: Ticks to wait, OS_NO_WAIT or OS_WAIT_FOREVER
+   - bits: Flags of the group when the task was released or timed out (optional)
+ Returns:
+   - OS_EventError_t: Error code indicating the result of the operation */
+OS_EventError_t os_eventGroupWait(EventGroup_t *group, uint32 bitsToWait, uint8 options, uint32 timeout, uint32 *bits);
+
+// Set flags and release the waiting tasks they satisfy.
+OS_EventError_t os_eventGroupSet(EventGroup_t *group, uint32 bitsToSet);
+
+/* os_eventGroupSet callable from an ISR. A context switch is requested only when a
+   released task has a higher priority than the interrupted one. */
+OS_EventError_t os_eventGroupSetFromISR(EventGroup_t *group, uint32 bitsToSet);
+
+// Clear flags, returns the flags before clearing.
+uint32 os_eventGroupClear(EventGroup_t *group, uint32 bitsToClear);
+
+// Current flags of the group.
+uint32 os_eventGroupGetBits(const EventGroup_t *group);
+
+
+
+
+#endif /* KERNEL_EVENTGROUP_H_ */
@@ -0,0 +1,63 @@
+/**
+ *******************************************************************************
+ * File           : List.h
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Intrusive doubly linked lists used by the kernel to keep
+ *                  task control blocks in ready, delay and wait lists.
+ *******************************************************************************
+ */
+#ifndef KERNEL_LIST_H_
+#define KERNEL_LIST_H_
+
+
+// Node embedded in the object to be linked
+typedef struct ListNode_t
+{
+    struct ListNode_t *next;        // Next node in the list, NULL at the tail
+    struct ListNode_t *prev;        // Previous node in the list, NULL at the head
+    struct List_t     *container;   // List currently holding the node, NULL when not linked
+    void              *owner;       // Object owning the node
+    uint32             value;       // Sorting key used by ordered lists
+} ListNode_t;
+
+
+// List head
+typedef struct List_t
+{
+    ListNode_t *head;               // First node, NULL when the list is empty
+    ListNode_t *tail;               // Last node, NULL when the list is empty
+    uint32      count;              // Number of linked nodes
+} List_t;
+
+
+// Check whether a list holds no nodes
+#define LIST_IS_EMPTY(list)         ((list)->head == NULL)
+
+// Check whether a node is linked in a list
+#define LIST_IS_LINKED(node)        ((node)->container != NULL)
+
+// Get the owner of the first node of a non empty list
+#define LIST_HEAD_OWNER(list)       ((list)->head->owner)
+
+
+// Initialize an empty list.
+void List_init(List_t *list);
+
+// Initialize an unlinked node owned by the specified object.
+void List_initNode(ListNode_t *node, void *owner);
+
+// Append a node at the tail of a list, O(1).
+void List_insertTail(List_t *list, ListNode_t *node);
+
+// Insert a node keeping the list in ascending order of value, after nodes of equal value.
+// Values are compared wraparound-safe, so tick deadlines may cross the 32-bit limit.
+void List_insertOrdered(List_t *list, ListNode_t *node);
+
+// Unlink a node from the list holding it, O(1). Unlinked nodes are ignored.
+void List_remove(ListNode_t *node);
+
+
+
+#endif /* KERNEL_LIST_H_ */
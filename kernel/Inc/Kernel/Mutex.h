@@ -0,0 +1,51 @@
+/**
+ *******************************************************************************
+ * File           : Mutex.h
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Including APIs and interfaces of recursive mutexes with
+ *                  priority inheritance, for task context only.
+ *******************************************************************************
+ */
+#ifndef KERNEL_MUTEX_H_
+#define KERNEL_MUTEX_H_
+
+#include "List.h"
+#include "Task.h"
+
+
+// Structure representing a mutex
+typedef struct Mutex_t
+{
+    Task_t *owner;                  // Task holding the mutex, NULL when free
+    uint32  lockCount;              // Recursive lock depth of the owner
+    List_t  waiters;                // Tasks waiting for the mutex, highest priority first
+} Mutex_t;
+
+
+// Define Enumeration for error codes
+typedef enum {
+    OS_MUTEX_SUCCESS = 0,   // Operation successful
+    OS_MUTEX_INVALID,       // NULL mutex
+    OS_MUTEX_BUSY,          // Owned by another task and no time to wait
+    OS_MUTEX_TIMEOUT,       // The wait for the mutex expired
+    OS_MUTEX_NOT_OWNER      // Unlocked by a task not owning it
+} OS_MutexError_t;
+
+
+// Initialize a free mutex.
+OS_MutexError_t os_mutexCreate(Mutex_t *mutex);
+
+/* Lock the mutex, waiting up to timeout ticks if another task owns it.
+   The owner can lock it again, each lock needs its own unlock.
+   While a task waits, the owner runs at least at the waiter's priority. */
+OS_MutexError_t os_mutexLock(Mutex_t *mutex, uint32 timeout);
+
+// Unlock the mutex, the highest priority waiter becomes the owner when the last lock is released.
+OS_MutexError_t os_mutexUnlock(Mutex_t *mutex);
+
+
+
+
+#endif /* KERNEL_MUTEX_H_ */
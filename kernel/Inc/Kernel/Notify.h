@@ -0,0 +1,60 @@
+/**
+ *******************************************************************************
+ * File           : Notify.h
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Including APIs and interfaces of direct to task notifications,
+ *                  a 32-bit value in every task control block used as a light
+ *                  counting semaphore, event flags or mailbox without a kernel
+ *                  object.
+ *******************************************************************************
+ */
+#ifndef KERNEL_NOTIFY_H_
+#define KERNEL_NOTIFY_H_
+
+#include "Task.h"
+
+
+// Action applied to the notification value of the target task
+typedef enum OS_NotifyAction_t
+{
+    OS_NOTIFY_SET_BITS = 0,     // value |= bits
+    OS_NOTIFY_INCREMENT,        // value++, the parameter is ignored
+    OS_NOTIFY_OVERWRITE         // value = parameter, a pending value is lost
+} OS_NotifyAction_t;
+
+
+// Define Enumeration for error codes
+typedef enum {
+    OS_NOTIFY_SUCCESS = 0,      // Operation successful
+    OS_NOTIFY_INVALID,          // NULL or deleted task, unknown action
+    OS_NOTIFY_EMPTY,            // Nothing pending and no time to wait
+    OS_NOTIFY_TIMEOUT           // The wait for a notification expired
+} OS_NotifyError_t;
+
+
+// Notify a task, it becomes ready if it is waiting for a notification.
+OS_NotifyError_t os_notify(Task_Handler_t taskhandler, uint32 value, OS_NotifyAction_t action);
+
+/* os_notify callable from an ISR. A context switch is requested only when the
+   woken task has a higher priority than the interrupted one. */
+OS_NotifyError_t os_notifyFromISR(Task_Handler_t taskhandler, uint32 value, OS_NotifyAction_t action);
+
+// Wait up to timeout ticks for a notification of the calling task, bits are cleared from the value
+// before the wait (clearOnEntry) and once it is received (clearOnExit), value gets it when not NULL.
+OS_NotifyError_t os_notifyWait(uint32 clearOnEntry, uint32 clearOnExit, uint32 *value, uint32 timeout);
+
+// Semaphore like use: increment the notification value of a task.
+OS_NotifyError_t os_notifyGive(Task_Handler_t taskhandler);
+OS_NotifyError_t os_notifyGiveFromISR(Task_Handler_t taskhandler);
+
+/* Semaphore like use: wait up to timeout ticks for a non zero notification value of the calling task,
+   then decrement it, or clear it (clearOnExit) to take all the gives at once.
+   Returns the value before it was decremented or cleared, 0 when the wait expired. */
+uint32 os_notifyTake(boolean clearOnExit, uint32 timeout);
+
+
+
+
+#endif /* KERNEL_NOTIFY_H_ */
@@ -0,0 +1,85 @@
+/**
+ *******************************************************************************
+ * File           : Queue.h
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Including APIs and interfaces of message queues
+ *******************************************************************************
+ */
+#ifndef KERNEL_QUEUE_H_
+#define KERNEL_QUEUE_H_
+
+#include "List.h"
+
+
+// Structure representing a message queue of fixed size elements
+typedef struct Queue_t
+{
+    uint8  *buffer;                 // Ring buffer storage supplied by the caller
+    uint32  itemSize;               // Size of one element in bytes
+    uint32  length;                 // Capacity of the queue in elements
+    uint32  head;                   // Index of the oldest element
+    uint32  count;                  // Number of elements ready to be received
+    boolean reserved;               // A slot is reserved by os_queueReserve, not committed yet
+    boolean acquired;               // The head slot is acquired by os_queueAcquire, not released yet
+    List_t  sendWaiters;            // Tasks waiting for a free slot
+    List_t  receiveWaiters;         // Tasks waiting for an element
+} Queue_t;
+
+
+// Define Enumeration for error codes
+typedef enum {
+    OS_QUEUE_SUCCESS = 0,   // Operation successful
+    OS_QUEUE_INVALID,       // NULL queue, storage or zero size
+    OS_QUEUE_FULL,          // No free slot and no time to wait
+    OS_QUEUE_EMPTY,         // No element and no time to wait
+    OS_QUEUE_TIMEOUT        // The wait for a slot or an element expired
+} OS_QueueError_t;
+
+
+/* Function to create a message queue on caller supplied storage
+ Parameters:
+   - queue: Queue control block to initialize
+   - storage: Ring buffer of at least itemSize * length bytes
+   - itemSize: Size of one element in bytes
+   - length: Capacity of the queue in elements
+ Returns:
+   - OS_QueueError_t: Error code indicating the result of the operation */
+OS_QueueError_t os_queueCreate(Queue_t *queue, void *storage, uint32 itemSize, uint32 length);
+
+// Copy an element to the back of the queue, waiting up to timeout ticks for a free slot.
+OS_QueueError_t os_queueSend(Queue_t *queue, const void *item, uint32 timeout);
+
+// Copy the element at the front of the queue out, waiting up to timeout ticks for one.
+OS_QueueError_t os_queueReceive(Queue_t *queue, void *item, uint32 timeout);
+
+// Non blocking os_queueSend, callable from an ISR.
+OS_QueueError_t os_queueSendFromISR(Queue_t *queue, const void *item);
+
+// Non blocking os_queueReceive, callable from an ISR.
+OS_QueueError_t os_queueReceiveFromISR(Queue_t *queue, void *item);
+
+/* Zero-copy send: reserve the next free slot to be written in place, then publish it
+   with os_queueCommit. Only one slot can be reserved at a time, other senders wait
+   until it is committed. */
+OS_QueueError_t os_queueReserve(Queue_t *queue, void **slot, uint32 timeout);
+
+// Publish the slot reserved by os_queueReserve to the receivers.
+void os_queueCommit(Queue_t *queue);
+
+/* Zero-copy receive: acquire the element at the front of the queue to be read in place,
+   then free its slot with os_queueRelease. Only one element can be acquired at a time,
+   other receivers wait until it is released. */
+OS_QueueError_t os_queueAcquire(Queue_t *queue, void **slot, uint32 timeout);
+
+// Free the slot acquired by os_queueAcquire.
+void os_queueRelease(Queue_t *queue);
+
+// Number of elements waiting in the queue.
+uint32 os_queueGetCount(const Queue_t *queue);
+
+
+
+
+#endif /* KERNEL_QUEUE_H_ */
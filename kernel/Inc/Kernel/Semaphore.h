@@ -0,0 +1,57 @@
+/**
+ *******************************************************************************
+ * File           : Semaphore.h
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Including APIs and interfaces of counting and binary semaphores
+ *******************************************************************************
+ */
+#ifndef KERNEL_SEMAPHORE_H_
+#define KERNEL_SEMAPHORE_H_
+
+#include "List.h"
+
+
+// Structure representing a counting semaphore, a binary semaphore has maxCount 1
+typedef struct Semaphore_t
+{
+    uint32 count;                   // Available units
+    uint32 maxCount;                // Upper limit of count
+    List_t waiters;                 // Tasks waiting for a unit, highest priority first
+} Semaphore_t;
+
+
+// Define Enumeration for error codes
+typedef enum {
+    OS_SEMAPHORE_SUCCESS = 0,   // Operation successful
+    OS_SEMAPHORE_INVALID,       // NULL semaphore, zero maxCount or initial count above it
+    OS_SEMAPHORE_EMPTY,         // No unit and no time to wait
+    OS_SEMAPHORE_TIMEOUT,       // The wait for a unit expired
+    OS_SEMAPHORE_OVERFLOW       // Given while already at maxCount
+} OS_SemaphoreError_t;
+
+
+// Initialize a semaphore holding initialCount units out of maxCount.
+OS_SemaphoreError_t os_semaphoreCreate(Semaphore_t *semaphore, uint32 initialCount, uint32 maxCount);
+
+// Take a unit, waiting up to timeout ticks for one.
+OS_SemaphoreError_t os_semaphoreTake(Semaphore_t *semaphore, uint32 timeout);
+
+// Non blocking os_semaphoreTake, callable from an ISR.
+OS_SemaphoreError_t os_semaphoreTakeFromISR(Semaphore_t *semaphore);
+
+// Give a unit back and wake the highest priority waiter.
+OS_SemaphoreError_t os_semaphoreGive(Semaphore_t *semaphore);
+
+/* os_semaphoreGive callable from an ISR. A context switch is requested only when the
+   woken task has a higher priority than the interrupted one. */
+OS_SemaphoreError_t os_semaphoreGiveFromISR(Semaphore_t *semaphore);
+
+// Number of available units.
+uint32 os_semaphoreGetCount(const Semaphore_t *semaphore);
+
+
+
+
+#endif /* KERNEL_SEMAPHORE_H_ */
@@ -0,0 +1,96 @@
+/**
+ *******************************************************************************
+ * File           : StreamBuffer.h
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Including APIs and interfaces of stream buffers, a lock-free
+ *                  byte ring between one producer and one consumer, each a
+ *                  task or an ISR. Both ends read and write the ring in place
+ *                  (reserve/commit, acquire/release) so a DMA can use it, and
+ *                  a blocked reader is woken once its trigger level of bytes
+ *                  has arrived rather than for every byte. A blocked task
+ *                  waits on its notification value (Notify.h).
+ *******************************************************************************
+ */
+#ifndef KERNEL_STREAMBUFFER_H_
+#define KERNEL_STREAMBUFFER_H_
+
+#include "Task.h"
+
+
+// Structure representing a stream buffer, head and tail count the bytes read and written since its creation
+typedef struct StreamBuffer_t
+{
+    uint8  *buffer;                 // Ring storage supplied by the caller
+    uint32  size;                   // Capacity of the ring in bytes, power of 2
+    volatile uint32 head;           // Bytes read, written by the consumer only
+    volatile uint32 tail;           // Bytes written, written by the producer only
+    volatile uint32 triggerLevel;   // Bytes that wake a blocked reader
+    Task_t * volatile reader;       // Task blocked until triggerLevel bytes are there, NULL otherwise
+    Task_t * volatile writer;       // Task blocked until space is free, NULL otherwise
+} StreamBuffer_t;
+
+
+// Define Enumeration for error codes
+typedef enum {
+    OS_STREAM_SUCCESS = 0,  // Operation successful
+    OS_STREAM_INVALID       // NULL stream or storage, size not a power of 2, trigger level 0 or above the size
+} OS_StreamError_t;
+
+
+/* Function to create a stream buffer on caller supplied storage
+ Parameters:
+   - stream: Stream buffer control block to initialize
+   - storage: Ring of size bytes
+   - size: Capacity in bytes, a power of 2
+   - triggerLevel: Bytes a blocked reader waits for, 1 .. size
+ Returns:
+   - OS_StreamError_t: Error code indicating the result of the operation */
+OS_StreamError_t os_streamCreate(StreamBuffer_t *stream, void *storage, uint32 size, uint32 triggerLevel);
+
+// Change the number of bytes a blocked reader waits for, 1 .. size.
+OS_StreamError_t os_streamSetTriggerLevel(StreamBuffer_t *stream, uint32 triggerLevel);
+
+/* Copy up to length bytes into the stream, waiting up to timeout ticks for space while bytes are left.
+   Returns the number of bytes written. */
+uint32 os_streamSend(StreamBuffer_t *stream, const void *data, uint32 length, uint32 timeout);
+
+/* Wait up to timeout ticks for the trigger level of bytes, then copy up to maxLength bytes out,
+   fewer when the wait expired. Returns the number of bytes read. */
+uint32 os_streamReceive(StreamBuffer_t *stream, void *data, uint32 maxLength, uint32 timeout);
+
+// Non blocking os_streamSend, callable from an ISR.
+uint32 os_streamSendFromISR(StreamBuffer_t *stream, const void *data, uint32 length);
+
+// Non blocking os_streamReceive, callable from an ISR.
+uint32 os_streamReceiveFromISR(StreamBuffer_t *stream, void *data, uint32 maxLength);
+
+/* Zero-copy write: wait up to timeout ticks for free space and get the contiguous free bytes at the tail
+   of the ring to be written in place, then publish them with os_streamCommit. Callable from an ISR with
+   OS_NO_WAIT. Returns the number of contiguous free bytes, 0 when the wait expired. */
+uint32 os_streamReserve(StreamBuffer_t *stream, uint8 **data, uint32 timeout);
+
+// Publish length bytes written in place after os_streamReserve to the reader.
+void os_streamCommit(StreamBuffer_t *stream, uint32 length);
+void os_streamCommitFromISR(StreamBuffer_t *stream, uint32 length);
+
+/* Zero-copy read: wait up to timeout ticks for the trigger level of bytes and get the contiguous bytes at
+   the head of the ring to be read in place, then free them with os_streamRelease. Callable from an ISR with
+   OS_NO_WAIT. Returns the number of contiguous bytes, fewer than the trigger level when the ring wraps. */
+uint32 os_streamAcquire(StreamBuffer_t *stream, uint8 **data, uint32 timeout);
+
+// Free length bytes read in place after os_streamAcquire for the writer.
+void os_streamRelease(StreamBuffer_t *stream, uint32 length);
+void os_streamReleaseFromISR(StreamBuffer_t *stream, uint32 length);
+
+// Number of bytes waiting in the stream.
+uint32 os_streamGetCount(const StreamBuffer_t *stream);
+
+// Number of bytes that can be written to the stream.
+uint32 os_streamGetSpace(const StreamBuffer_t *stream);
+
+
+
+
+#endif /* KERNEL_STREAMBUFFER_H_ */
@@ -10,6 +10,8 @@
 #ifndef KERNEL_TASK_H_
 #define KERNEL_TASK_H_
 
+#include "kernel_interface.h"
+#include "List.h"
 
 // Function pointer type for task functions
 typedef void (*osFunc_t)(void);
@@ -28,29 +30,110 @@ typedef enum Task_State_t
 // Structure representing a task
 typedef struct Task_t
 {
+    volatile uint32 *psp;        		 // Pointer to the Process Stack Pointer (PSP), first so the context switch reaches it at offset 0
     volatile osFunc_t task_func;    	 // Pointer to the task function
     volatile uint32 id;          		 // Task ID
-    volatile uint32 priority;    		 // Task priority level
+    volatile uint32 priority;    		 // Task priority level, raised while it holds a mutex a higher priority task waits for
+    volatile uint32 basePriority;        // Priority given at creation
+    volatile uint32 mutexesHeld;         // Number of mutexes owned by the task
     volatile uint32 stackSize;   		 // Size of the task's stack
-    volatile uint32 *psp;        		 // Pointer to the Process Stack Pointer (PSP)
+    volatile uint32 *stackLimit;         // Lowest address of the task's stack
     volatile Task_State_t state;   		 // Current state of the task
-    volatile uint32 blockTicks;  		 // Number of ticks to delay task execution (if blocked)
+    volatile uint32 blockTicks;  		 // SysTick value at which a blocked task wakes up
     volatile char name[TASK_NAME_LEN];   // Name of the task
+    ListNode_t readyNode;                // Link in the ready list of its priority
+    ListNode_t delayNode;                // Link in the delay list, sorted by blockTicks
+    ListNode_t eventNode;                // Link in the wait list of a kernel object, highest priority first
+    volatile boolean eventTimedOut;      // Set when the wait on a kernel object ended without it: expired or suspended
+    volatile uint32 eventBits;           // Event flags waited for, then the flags that released the task
+    volatile uint8 eventOptions;         // Event flags wait options
+    volatile uint32 notifyValue;         // Direct to task notification value
+    volatile uint8 notifyState;          // NOTIFY_NONE, NOTIFY_WAITING or NOTIFY_PENDING
+    volatile osFunc_t job;               // Function a periodic task runs once per period
+    volatile uint32 period;              // Period of a periodic task in ticks, 0 otherwise
+    volatile uint32 wakeTime;            // Tick the current period of a periodic task started at
+    volatile uint32 overruns;            // Periods missed in os_delayUntil
+    volatile uint32 core;                // Core whose ready list holds the task, the core it runs on
+    volatile uint32 affinity;            // Cores the task may run on, bit n for core n
+    volatile uint32 timeSlice;           // Ticks of its time slice, 0 for TIME_SLICE_TICKS
+#if SCHEDULE_ALGORITHM == EDF
+    volatile uint32 relativeDeadline;    // Deadline of every job after its release in ticks, 0 for a task without deadline
+    volatile uint32 deadline;            // Absolute deadline tick of the current job
+    volatile uint32 density;             // WCET / min(deadline, period) in millionths, reserved by the admission control
+    volatile uint32 heapIndex;           // Position in the ready heap
+#endif
+#if RUNTIME_STATS == ENABLED
+    volatile uint64 runTime;             // Microseconds spent running
+    volatile uint32 switchCount;         // Number of times the task was switched in
+    volatile uint32 readyTime;           // Run time counter when the task started waiting to run
+    volatile uint32 maxLatency;          // Longest wait in microseconds from ready to running
+#endif
 } Task_t;
 
 
+#if RUNTIME_STATS == ENABLED
+
+// Snapshot of the statistics of a task
+typedef struct TaskStats_t
+{
+    uint32 id;                          // Task ID
+    char name[TASK_NAME_LEN];           // Name of the task
+    Task_State_t state;                 // State of the task
+    uint32 priority;                    // Effective priority
+    uint64 runTime;                     // Microseconds spent running
+    uint32 switchCount;                 // Number of times the task was switched in
+    uint32 maxLatency;                  // Longest wait in microseconds from ready to running
+} TaskStats_t;
+
+#endif
+
+
 // Define Enumeration for error codes
 typedef enum {
-    OS_TASK_SUCCESS = 0,    // Task creation successful
-    OS_TASK_NULL_FUNC,      // Task function pointer is NULL
-    OS_TASK_LONG_NAME,      // Task name exceeds maximum length
-    OS_TASK_STACK_OVERFLOW  // Insufficient stack space
+    OS_TASK_SUCCESS = 0,      // Task creation successful
+    OS_TASK_NULL_FUNC,        // Task function pointer is NULL
+    OS_TASK_LONG_NAME,        // Task name exceeds maximum length
+    OS_TASK_STACK_OVERFLOW,   // Insufficient stack space
+    OS_TASK_INVALID_PRIORITY, // Priority is not below MAX_PRIORITIES
+    OS_TASK_NO_SLOT,          // Every task control block is in use
+    OS_TASK_INVALID_PERIOD,   // Period of a periodic task is 0, or a deadline task timing is inconsistent
+    OS_TASK_NOT_SCHEDULABLE,  // The deadline task would raise the total density above 1
+    OS_TASK_INVALID_AFFINITY  // No existing core in the affinity, or an idle task
 } OS_TaskError_t;
 
 
 typedef Task_t* Task_Handler_t;
 
 
+#if STATIC_TASKS == ENABLED
+
+#include "task_table_cfg.h"
+
+// Tasks os_init creates ahead of the static table: the idle task of every core, the work queue and timer daemons
+// and the coroutine executor
+#define KERNEL_TASK_COUNT           (NUM_CORES + ((WORK_QUEUE == ENABLED) ? 1 : 0) + ((SOFTWARE_TIMERS == ENABLED) ? 1 : 0) \
+                                               + ((COROUTINES == ENABLED) ? 1 : 0))
+
+#define STATIC_TASK_ID(taskName, taskFunction, taskPriority, taskStackSize)       OS_TASK_ID_##taskName,
+#define STATIC_TASK_HANDLE(taskName, taskFunction, taskPriority, taskStackSize)   extern Task_Handler_t const OS_TaskHandle_##taskName;
+
+// IDs of the static tasks, following the kernel tasks
+enum { OS_TASK_ID_KERNEL_LAST = KERNEL_TASK_COUNT - 1, OS_STATIC_TASKS(STATIC_TASK_ID) OS_STATIC_TASKS_END };
+
+// Handle of every static task, OS_TaskHandle_<name>
+OS_STATIC_TASKS(STATIC_TASK_HANDLE)
+
+// Task control blocks: the kernel tasks, the static table and MAX_TASKS tasks created at runtime
+#define TASK_TABLE_SIZE             (OS_STATIC_TASKS_END + MAX_TASKS)
+
+#else
+
+// Task control blocks: the idle task and MAX_TASKS tasks
+#define TASK_TABLE_SIZE             (MAX_TASKS + 1)
+
+#endif
+
+
 /* Function to create a new task in the operating system
  Parameters:
    - task_handler: Pointer to a task handler variable where the task control block pointer will be stored (optional)
@@ -63,18 +146,95 @@ typedef Task_t* Task_Handler_t;
 OS_TaskError_t OS_createTask(Task_Handler_t* task_handler, const osFunc_t task_func, const char* name, const uint32 priority, const uint32 stackSize);
 
 
+/* Function to create a task running a job once every period ticks, the first time right away.
+   The job returns when its work for the period is done, missed periods are skipped (os_delayUntil).
+ Parameters:
+   - task_handler: Pointer to a task handler variable where the task control block pointer will be stored (optional)
+   - job: Function run once per period
+   - name: Name of the task
+   - priority: Priority level of the task
+   - stackSize: Size of the task's stack
+   - period: Period in ticks
+ Returns:
+   - OS_TaskError_t: Error code indicating the result of the task creation operation */
+OS_TaskError_t OS_createPeriodicTask(Task_Handler_t* task_handler, const osFunc_t job, const char* name, const uint32 priority,
+                                     const uint32 stackSize, const uint32 period);
+
+
+#if SCHEDULE_ALGORITHM == EDF
+/* Function to create a periodic task scheduled earliest deadline first, ahead of the tasks without deadline.
+   Every job is released at the start of its period and must complete within deadline ticks.
+   The task is rejected when the sum of wcet / min(deadline, period) over the deadline tasks would exceed 1,
+   the condition for EDF to meet every deadline.
+ Parameters:
+   - task_handler: Pointer to a task handler variable where the task control block pointer will be stored (optional)
+   - job: Function run once per period
+   - name: Name of the task
+   - stackSize: Size of the task's stack
+   - period: Period in ticks
+   - deadline: Relative deadline of every job in ticks
+   - wcet: Worst case execution time of a job in ticks
+ Returns:
+   - OS_TaskError_t: Error code indicating the result of the task creation operation */
+OS_TaskError_t OS_createDeadlineTask(Task_Handler_t* task_handler, const osFunc_t job, const char* name, const uint32 stackSize,
+                                     const uint32 period, const uint32 deadline, const uint32 wcet);
+#endif
+
+
 // To introduce a delay in the execution of the current task
 void os_delay(uint32 ticks);
 
+/* Delay the current task until *lastWakeTime + period, an absolute tick so the period does not drift.
+   *lastWakeTime is set to the wake tick for the next call, initialize it with os_getTickCount().
+   When the wake tick already passed, the missed periods are skipped so the task stays in phase.
+ Returns:
+   - uint32: Number of periods missed, also added to the task overruns */
+uint32 os_delayUntil(uint32 *lastWakeTime, uint32 period);
+
+// Number of periods the task missed in os_delayUntil since it was created.
+uint32 os_getTaskOverruns(Task_Handler_t taskhandler);
+
 // Suspend the specified task.
 void os_suspendTask(Task_Handler_t taskhandler);
 
 // Resume the specified suspended task.
 void os_resumeTask(Task_Handler_t taskhandler);
 
-// Delete the specified task for ever.
+/* Delete the specified task for ever, its control block and stack are reused by the next created tasks.
+   A task deleting itself is reclaimed once the scheduler switched away from it.
+   The idle tasks can not be deleted and the handle must not be used afterwards. */
 void os_deleteTask(Task_Handler_t taskhandler);
 
+/* Restrict the cores the specified task may run on, bit n for core n (NUM_CORES).
+   A task is created allowed on every core, one running on a core it leaves moves at its next switch. */
+OS_TaskError_t os_setTaskAffinity(Task_Handler_t taskhandler, uint32 coreMask);
+
+/* Set the ticks the specified task runs before a ready task of the same level takes over,
+   0 restores TIME_SLICE_TICKS. It applies from the next time slice of the task. */
+void os_setTaskTimeSlice(Task_Handler_t taskhandler, uint32 ticks);
+
+#if STACK_PAINTING == ENABLED
+// Peak number of stack bytes the task has used since it was created.
+uint32 os_getStackHighWaterMark(Task_Handler_t taskhandler);
+#endif
+
+#if STACK_OVERFLOW_CHECK == ENABLED
+/* Called from the context switch when the task switched out went past its stack limit or its canary
+   was overwritten. The default halts with interrupts disabled, the application may override it. */
+void os_stackOverflowHook(Task_Handler_t taskhandler);
+#endif
+
+#if RUNTIME_STATS == ENABLED
+/* Copy the statistics of up to maxTasks existing tasks, the idle tasks first.
+ Parameters:
+   - stats: Array receiving the snapshots
+   - maxTasks: Number of elements of stats
+   - cpuLoad: Share of the time spent outside the idle tasks since the previous call, in 0.01 % units (optional)
+ Returns:
+   - uint32: Number of tasks copied */
+uint32 os_getTaskStats(TaskStats_t *stats, uint32 maxTasks, uint32 *cpuLoad);
+#endif
+
 
 
 
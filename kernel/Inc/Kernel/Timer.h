@@ -0,0 +1,63 @@
+/**
+ *******************************************************************************
+ * File           : Timer.h
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Including APIs and interfaces of the software timers. Active
+ *                  timers are kept sorted on their expiry tick and a daemon task
+ *                  created by os_init runs the callbacks of all the timers due
+ *                  on a tick in one batch (SOFTWARE_TIMERS enabled).
+ *******************************************************************************
+ */
+#ifndef KERNEL_TIMER_H_
+#define KERNEL_TIMER_H_
+
+#include "List.h"
+
+
+typedef void (*osTimerFunc_t)(void *argument);
+
+
+// Structure representing a software timer, owned by the application
+typedef struct Timer_t
+{
+    osTimerFunc_t function;         // Run by the timer daemon when the timer expires
+    void *argument;                 // Passed to function
+    volatile uint32 period;         // Ticks given to the last os_timerStart
+    volatile boolean autoReload;    // Started again for another period when it expires, one-shot otherwise
+    ListNode_t node;                // Link in the active timers, value is the expiry tick
+} Timer_t;
+
+
+// Define Enumeration for error codes
+typedef enum {
+    OS_TIMER_SUCCESS = 0,       // Operation successful
+    OS_TIMER_INVALID            // NULL timer or function, period of 0 ticks or never started
+} OS_TimerError_t;
+
+
+#if SOFTWARE_TIMERS == ENABLED
+
+// Initialize a stopped timer running function(argument), once or every period (autoReload).
+OS_TimerError_t os_timerInit(Timer_t *timer, osTimerFunc_t function, void *argument, boolean autoReload);
+
+/* Start a timer expiring ticks from now, an active timer is restarted. An auto-reload
+   timer then expires every ticks, without drifting. Callable from an ISR. */
+OS_TimerError_t os_timerStart(Timer_t *timer, uint32 ticks);
+
+// Start a timer again for its last period from now. Callable from an ISR.
+OS_TimerError_t os_timerReset(Timer_t *timer);
+
+// Stop a timer, a callback the daemon already started still completes. Callable from an ISR.
+OS_TimerError_t os_timerStop(Timer_t *timer);
+
+// Whether a timer is waiting to expire.
+boolean os_timerIsActive(const Timer_t *timer);
+
+#endif
+
+
+
+
+#endif /* KERNEL_TIMER_H_ */
@@ -0,0 +1,86 @@
+/**
+ *******************************************************************************
+ * File           : Trace.h
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Including APIs and interfaces of the kernel event trace
+ *                  recorder. Events are written as fixed size records in a
+ *                  RAM ring buffer, dumped and converted on the host by
+ *                  tools/trace2perfetto.py.
+ *******************************************************************************
+ */
+#ifndef KERNEL_TRACE_H_
+#define KERNEL_TRACE_H_
+
+
+#define TRACE_MAGIC                 0x31435254  // "TRC1" in memory
+
+
+// Enumeration of the recorded events
+typedef enum TraceEvent_t
+{
+    TRACE_TASK_SWITCH = 1,  // task: switched in task, data: switched out task
+    TRACE_TICK,             // task: running task, data: low half of SysTick
+    TRACE_TASK_CREATE,      // task: created task, data: priority
+    TRACE_TASK_DELAY,       // task: delayed task, data: ticks, saturated to 0xFFFF
+    TRACE_TASK_SUSPEND,     // task: suspended task
+    TRACE_TASK_RESUME,      // task: resumed task
+    TRACE_TASK_DELETE,      // task: deleted task
+    TRACE_ISR_ENTER,        // task: interrupted task, data: interrupt number
+    TRACE_ISR_EXIT          // task: interrupted task, data: interrupt number
+} TraceEvent_t;
+
+
+// Structure of one record, 8 bytes
+typedef struct TraceRecord_t
+{
+    uint32 timestamp;       // SysTick * countsPerTick + elapsed timer counts, wraps around
+    uint8  event;           // TraceEvent_t
+    uint8  task;            // Task ID
+    uint16 data;            // Event specific
+} TraceRecord_t;
+
+
+// Structure of the trace buffer, dumped as is from the target memory
+typedef struct TraceBuffer_t
+{
+    uint32 magic;                                   // TRACE_MAGIC
+    uint16 length;                                  // Number of records of the ring
+    uint16 nameLength;                              // TASK_NAME_LEN
+    uint32 maxTasks;                                // Number of task names
+    uint32 countsPerTick;                           // Timer counts of one tick
+    uint32 tickMicroSec;                            // Duration of one tick
+    volatile uint32 written;                        // Records written since the start, the next one goes to written % length
+    char taskNames[TASK_TABLE_SIZE][TASK_NAME_LEN]; // Names of the tasks, indexed by task ID
+    TraceRecord_t records[TRACE_BUFFER_LENGTH];     // Ring of records
+} TraceBuffer_t;
+
+
+#if TRACE_RECORDER == ENABLED
+
+#define TRACE_RECORD(event, task, data)     traceRecord((event), (task), (data))
+
+// Write a record in the ring, lock free so it can be called from any context.
+void traceRecord(uint8 event, uint8 task, uint16 data);
+
+// Record the entry and exit of an application ISR, called first and last thing in the handler.
+void os_traceIsrEnter(uint16 irq);
+void os_traceIsrExit(uint16 irq);
+
+// Get the trace buffer to dump, sizeof(TraceBuffer_t) bytes.
+const TraceBuffer_t* os_traceGetBuffer(void);
+
+#else
+
+#define TRACE_RECORD(event, task, data)     do{ } while(0)
+
+#define os_traceIsrEnter(irq)               do{ } while(0)
+#define os_traceIsrExit(irq)                do{ } while(0)
+
+#endif
+
+
+
+
+#endif /* KERNEL_TRACE_H_ */
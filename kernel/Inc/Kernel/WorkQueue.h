@@ -0,0 +1,71 @@
+/**
+ *******************************************************************************
+ * File           : WorkQueue.h
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Including APIs and interfaces of the work queue. ISRs post
+ *                  work items in a lock-free ring and a daemon task created by
+ *                  os_init runs them in batches, so the interrupt handlers stay
+ *                  short (WORK_QUEUE enabled).
+ *******************************************************************************
+ */
+#ifndef KERNEL_WORKQUEUE_H_
+#define KERNEL_WORKQUEUE_H_
+
+
+typedef void (*osWorkFunc_t)(void *argument);
+
+
+// Structure representing a unit of deferred work, owned by the poster
+typedef struct Work_t
+{
+    osWorkFunc_t function;          // Run by the daemon task
+    void *argument;                 // Passed to function
+    volatile uint32 pending;        // Set from the post until the daemon starts running it
+} Work_t;
+
+
+// Snapshot of the work queue counters
+typedef struct WorkQueueStats_t
+{
+    uint32 depth;                   // Work items in the ring now
+    uint32 highWaterMark;           // Deepest the ring has been
+    uint32 posted;                  // Work items put in the ring
+    uint32 coalesced;               // Posts of a work item already pending, merged with it
+    uint32 dropped;                 // Posts refused because the ring was full
+    uint32 batches;                 // Times the daemon woke up to drain the ring
+    uint32 executed;                // Work items run
+} WorkQueueStats_t;
+
+
+// Define Enumeration for error codes
+typedef enum {
+    OS_WORK_SUCCESS = 0,        // Operation successful
+    OS_WORK_INVALID,            // NULL work item or function
+    OS_WORK_COALESCED,          // The work item was already pending, it runs once for both posts
+    OS_WORK_FULL                // WORK_QUEUE_LENGTH work items already pending
+} OS_WorkError_t;
+
+
+#if WORK_QUEUE == ENABLED
+
+// Initialize a work item running function(argument).
+OS_WorkError_t os_workInit(Work_t *work, osWorkFunc_t function, void *argument);
+
+// Queue a work item for the daemon task, a pending work item is not queued twice.
+OS_WorkError_t os_workPost(Work_t *work);
+
+/* os_workPost callable from an ISR. The ring is lock-free, interrupts are only
+   masked for the few instructions waking the daemon task. */
+OS_WorkError_t os_workPostFromISR(Work_t *work);
+
+// Get the work queue counters.
+void os_workQueueGetStats(WorkQueueStats_t *stats);
+
+#endif
+
+
+
+
+#endif /* KERNEL_WORKQUEUE_H_ */
@@ -12,14 +12,78 @@
 #define KERNEL_CFG_H_
 
 
+/*
+Options:
+         ROUND_ROBIN          // Ready tasks take turns every tick regardless of their priority
+         PRIORITY_PREEMPTIVE  // Highest priority ready task runs, round-robin among equal priorities
+         EDF                  // Deadline tasks (OS_createDeadlineTask) run earliest deadline first,
+                              // the other tasks run below them as in PRIORITY_PREEMPTIVE
+*/
 #define SCHEDULE_ALGORITHM          ROUND_ROBIN
 
+#define MAX_PRIORITIES              32          // Priorities 0 (idle) .. 31, must not exceed 32
+
+// Number of cores sharing the tasks, more than 1 needs PRIORITY_PREEMPTIVE and a port supporting it (POSIX_GCC_PORT)
+#define NUM_CORES                   1
+
 #define SYSTEM_TICK                 1           // 1 Millisecond
 
+// Ticks a task runs before a ready task of the same level takes over, os_setTaskTimeSlice overrides it per task.
+// The tick requests a context switch only when the slice ends or a woken task preempts the running one.
+#define TIME_SLICE_TICKS            1
+
+// Define whether the idle task stops the periodic tick and sleeps until the next delayed task is due
+#define TICKLESS_IDLE               DISABLED
+
+#define TICKLESS_MIN_IDLE_TICKS     2           // Shorter idle periods keep the periodic tick
+
+// Define whether the kernel events are recorded in a RAM ring buffer (Trace.h)
+#define TRACE_RECORDER              DISABLED
+
+#define TRACE_BUFFER_LENGTH         512         // Records of 8 bytes, power of 2
+
+// Define whether the scheduler records the run time, switch count and ready latency of every task
+#define RUNTIME_STATS               DISABLED
+
+// Define whether task stacks are painted at creation so os_getStackHighWaterMark can measure their use
+#define STACK_PAINTING              DISABLED
+
+// Define whether the scheduler checks the stack of every task it switches out (os_stackOverflowHook)
+#define STACK_OVERFLOW_CHECK        DISABLED
+
+// Define whether os_init creates the daemon task running the work deferred by ISRs (WorkQueue.h)
+#define WORK_QUEUE                  DISABLED
+
+#define WORK_QUEUE_LENGTH           16          // Pending work items, power of 2
+
+#define WORK_QUEUE_PRIORITY         (MAX_PRIORITIES - 1)
+
+#define WORK_QUEUE_STACK_SIZE       512         // 512 bytes
+
+// Define whether os_init creates the daemon task running the software timer callbacks (Timer.h)
+#define SOFTWARE_TIMERS             DISABLED
+
+#define TIMER_DAEMON_PRIORITY       (MAX_PRIORITIES - 1)
+
+#define TIMER_DAEMON_STACK_SIZE     512         // 512 bytes
+
+// Define whether os_init creates the executor task running the stackless coroutines (Coroutine.h)
+#define COROUTINES                  DISABLED
+
+#define COROUTINE_EXECUTOR_PRIORITY 1
+
+#define COROUTINE_STACK_SIZE        1024        // 1024 bytes, shared by all the coroutines
+
+// Define whether the tasks of the table in task_table_cfg.h are built at compile time
+#define STATIC_TASKS                DISABLED
+
 #define MAX_TASKS                   10          // Preferred to specify the actual number of tasks for memory efficiency
+                                                // With STATIC_TASKS, the tasks created at runtime on top of the table
 
 #define SCHEDULE_STACK_SIZE         1024        // 1024 bytes
 
+#define IDLE_TASK_STACK_SIZE        256         // 256 bytes, room for an exception frame and the tickless sleep
+
 #define DEFAULT_TASK_STACK_SIZE     1024        // 1024 bytes
 
 // Define the total application stack size in bytes
@@ -30,6 +94,10 @@
 // Define whether system faults are enabled or disabled
 #define SYSTEM_FAULTS               ENABLED
 
+// Cortex-M3: highest interrupt priority (1 .. 15, lower is more urgent) of the ISRs calling the kernel.
+// Kernel critical sections never mask the interrupts above it, they must not call the kernel.
+#define MAX_SYSCALL_INTERRUPT_PRIORITY  5
+
 // Define the start address of the schedule stack
 #define SCHEDULE_STACK_START        SRAM_END    // Start address of the schedule stack (assuming it starts at the end of SRAM)
 
@@ -17,9 +17,41 @@
 #include "kernel_cfg.h"
 
 
+// Scheduling algorithms, options of SCHEDULE_ALGORITHM in kernel_cfg.h
+#define ROUND_ROBIN                 0
+#define PRIORITY_PREEMPTIVE         1
+#define EDF                         2
+
+// Timeouts in ticks accepted by the blocking APIs
+#define OS_NO_WAIT                  0
+#define OS_WAIT_FOREVER             0xFFFFFFFF
+
+
+// Snapshot of the context switch requests of the tick, all the cores together
+typedef struct SwitchStats_t
+{
+    uint32 tickSwitches;            // Ticks that pended a context switch
+    uint32 avoidedSwitches;         // Ticks that left the running task in place without a PendSV
+} SwitchStats_t;
+
+
 void  os_init();
 
 void  os_start();
+
+// Number of ticks since os_start, wraps around.
+uint32 os_getTickCount(void);
+
+/* Time since os_start from the tick count and the SysTick timer, 64 bits so it never wraps.
+   Integer scaling only, callable from tasks and ISRs, consistent while the tick interrupt runs. */
+uint64 os_getTimeNs(void);
+uint64 os_getTimeUs(void);
+
+// Core the caller is running on, 0 .. NUM_CORES - 1. A task may be on another one right after.
+uint32 os_getCoreId(void);
+
+// Get the context switch counters of the tick handler.
+void os_getSwitchStats(SwitchStats_t *stats);
  
  
 #endif //_KERNEL_INTERFACE_H_
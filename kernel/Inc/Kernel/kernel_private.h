@@ -0,0 +1,175 @@
+/**
+ ************************************************************************
+ * File           : kernel_private.h
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Private kernel functions shared between the kernel
+ *                  sources and the port, not part of the application APIs.
+ ************************************************************************
+ */
+
+#ifndef _KERNEL_PRIVATE_H_
+#define _KERNEL_PRIVATE_H_
+
+#include "Task.h"
+#include "Trace.h"
+
+
+#if NUM_CORES > 1
+
+#if NUM_CORES > 32
+#error "NUM_CORES must not exceed the 32 bits of a task affinity"
+#endif
+
+#if SCHEDULE_ALGORITHM != PRIORITY_PREEMPTIVE
+#error "NUM_CORES above 1 needs the PRIORITY_PREEMPTIVE scheduler"
+#endif
+
+#if TICKLESS_IDLE == ENABLED
+#error "TICKLESS_IDLE stops the tick of a single core"
+#endif
+
+// Core the caller runs on, given by the port. Stable inside a critical section only.
+#define THIS_CORE                   GET_CORE_ID()
+
+// ID of the task running on every core
+extern volatile uint32 CurrentTasks[NUM_CORES];
+
+#define CURRENT_TASK_OF(core)       CurrentTasks[core]
+
+// ID of the calling task, the port reads it with interrupts masked since the task
+// may move to another core between reading its core and the entry of that core
+#define Current_Task                GET_CURRENT_TASK()
+
+#else
+
+#define THIS_CORE                   0
+
+// ID of the running task
+extern volatile uint32 Current_Task;
+
+// Control block of the running task, set by schedule() for the context switch of the port
+extern Task_t * volatile Current_TCB;
+
+#define CURRENT_TASK_OF(core)       Current_Task
+
+#endif
+
+// Whether a task is the one running on its core
+#define TASK_IS_RUNNING(task)       (CURRENT_TASK_OF((task)->core) == (task)->id)
+
+// Affinity of a task allowed on every core, bit n for core n
+#define ALL_CORES                   (0xFFFFFFFFUL >> (32 - NUM_CORES))
+
+
+// Function to perform task scheduling and determine the next task to run
+void schedule(void);
+
+// Function to unblock the delayed tasks whose wake tick has been reached, called every tick.
+// Returns whether one of them should preempt the current task.
+boolean checkBlockedTasks(void);
+
+// Charge a tick to the time slice of the task running on a core, called by the tick handler inside a critical section.
+// Returns whether the core needs a context switch: preempted (by a task the tick woke) or at the end of a contended slice.
+boolean tickSwitchRequired(uint32 core, boolean preempted);
+
+// Mark a task READY and link it in the ready structures of the selected scheduling algorithm.
+void addToReadyList(Task_t *task);
+
+// Unlink a READY task from the ready structures, the caller sets the new state.
+void removeFromReadyList(Task_t *task);
+
+// Link a task in the delay list until SysTick reaches wakeTick, wraparound-safe.
+void addToDelayList(Task_t *task, uint32 wakeTick);
+
+// Unlink a task from the delay list if it is waiting in it.
+void removeFromDelayList(Task_t *task);
+
+// Block the current task on the wait list of a kernel object for up to timeout ticks
+// and pend a context switch, called inside a critical section. A NULL eventList waits
+// on the task itself (notifications).
+void blockOnEventList(List_t *eventList, uint32 timeout);
+
+// Take a task out of the wait list and delay list it is blocked in and make it ready,
+// returns whether it should preempt the current task. Called inside a critical section.
+boolean unblockTask(Task_t *task);
+
+// Change the effective priority of a task and move it in the ready list or wait list it is linked in,
+// called inside a critical section.
+void setTaskPriority(Task_t *task, uint32 priority);
+
+// Give the control block and stack of a deleted task back to the allocator.
+void reclaimTask(Task_t *task);
+
+// Check whether a task that just became ready should preempt the current task.
+boolean isPreemptedBy(const Task_t *task);
+
+// Pend a context switch on a core, the calling one or another. Called inside a critical section.
+void preemptCore(uint32 core);
+
+// Value of the unused stack words and of the canary at the bottom of every stack
+#define STACK_PAINT_PATTERN         0xA5A5A5A5
+#define STACK_CANARY_WORDS          4
+
+// Notification state of a task
+#define NOTIFY_NONE                 0   // Nothing pending
+#define NOTIFY_WAITING              1   // Blocked in os_notifyWait or os_notifyTake
+#define NOTIFY_PENDING              2   // Notified since the last wait
+
+// os_notifyGive without the context switch, called by the tick inside a critical section.
+// Returns whether the task should preempt the current task, the tick pends the switch itself.
+boolean notifyGiveFromTick(Task_t *task);
+
+
+// Advance the tick count, called by the tick handler of the port and after a tickless sleep.
+void tickIncrement(uint32 ticks);
+
+// Read the 64-bit tick count and the timer counts elapsed since that tick as one consistent pair.
+void readTickTime(uint64 *ticks, uint32 *counts);
+
+#if RUNTIME_STATS == ENABLED
+// Microseconds counted from the tick and the SysTick timer, wraps every 71 minutes.
+uint32 getRunTimeCounter(void);
+
+// Charge the time since the last switch to the current task, called inside a critical section.
+void accountRunTime(uint32 now);
+#endif
+
+#if TRACE_RECORDER == ENABLED
+// Record the timer counts of a tick once the tick is running, called by os_start.
+void traceStart(void);
+
+// Keep the name of a task for the host converter.
+void traceTaskName(const Task_t *task);
+#endif
+
+#if WORK_QUEUE == ENABLED
+// Create the daemon task, called by os_init.
+void workQueueInit(void);
+#endif
+
+#if SOFTWARE_TIMERS == ENABLED
+// Create the daemon task, called by os_init.
+void timersInit(void);
+
+// Wake the daemon when the first timer is due, called every tick inside a critical section.
+// Returns whether the daemon should preempt the current task.
+boolean timersTick(void);
+
+// Ticks until the first timer is due, called by the tickless idle mode inside a critical section.
+uint32 timersIdleTicks(void);
+#endif
+
+#if COROUTINES == ENABLED
+// Create the executor task, called by os_init.
+void coroutinesInit(void);
+#endif
+
+#if STATIC_TASKS == ENABLED
+// Make the tasks of the static table ready, called by os_init.
+void staticTasksInit(void);
+#endif
+
+
+#endif //_KERNEL_PRIVATE_H_
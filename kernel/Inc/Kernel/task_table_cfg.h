@@ -0,0 +1,30 @@
+/**
+ *******************************************************************************
+ * File           : task_table_cfg.h
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Table of the tasks built at compile time (STATIC_TASKS
+ *                  enabled). Their control blocks, names and stacks are
+ *                  static data sized by the table, os_init only writes the
+ *                  initial stack frames and makes them ready.
+ *******************************************************************************
+ */
+#ifndef KERNEL_TASK_TABLE_CFG_H_
+#define KERNEL_TASK_TABLE_CFG_H_
+
+
+/* One TASK(name, function, priority, stackSize) entry per task, the name is an identifier
+   of at most TASK_NAME_LEN characters. A task gets the ID OS_TASK_ID_<name> and the handle
+   OS_TaskHandle_<name>, and can be deleted like any other task. Example:
+
+   #define OS_STATIC_TASKS(TASK)                \
+       TASK(LED,    ledTask,    2, 512)         \
+       TASK(BUTTON, buttonTask, 3, 256)
+*/
+#define OS_STATIC_TASKS(TASK)
+
+
+
+
+#endif /* KERNEL_TASK_TABLE_CFG_H_ */
@@ -49,6 +49,9 @@
 // Define the naked attribute
 #define NAKED		  __attribute__((naked))
 
+// Define the weak attribute for default implementations the application may override
+#define WEAK          __attribute__((weak))
+
 // Define the section attribute for placing functions in a specific section
 #define SECTION(name) __attribute__((section(name)))
 
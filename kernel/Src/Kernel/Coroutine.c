@@ -0,0 +1,271 @@
+/**
+ ******************************************************************************
+ * File           : Coroutine.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Implementation of the stackless coroutines and their executor task
+ ******************************************************************************
+ */
+
+#include <../Inc/LIB/std_types.h>
+#include <../Inc/LIB/common_macros.h>
+
+#include "../Inc/kernel/kernel_cfg.h"
+#include "../../Inc/kernel/port/port.h"
+#include "../../Inc/Kernel/Task.h"
+#include "../../Inc/Kernel/Notify.h"
+#include "../../Inc/Kernel/Coroutine.h"
+#include "../../Inc/Kernel/kernel_private.h"
+
+
+#if COROUTINES == ENABLED
+
+extern volatile uint32 SysTick;
+
+
+// Coroutines to run, in the order they became ready
+static List_t ReadyCoroutines;
+
+// Delayed coroutines and waits with a timeout, in ascending order of wake tick
+static List_t DelayedCoroutines;
+
+static Task_Handler_t Executor;
+
+
+// Queue a coroutine behind the ready ones, called inside a critical section.
+static void makeReady(Coroutine_t *co)
+{
+    List_remove(&co->node);
+
+    co->state = CO_READY;
+    List_insertTail(&ReadyCoroutines, &co->node);
+}
+
+
+// Hand the notified bits to a waiting coroutine, called inside a critical section.
+static void receive(Coroutine_t *co)
+{
+    co->received    = co->notifyValue;
+    co->notifyValue = 0;
+
+    makeReady(co);
+}
+
+
+// Link a coroutine in the delay list for ticks, called inside a critical section.
+static void delay(Coroutine_t *co, uint32 ticks)
+{
+    co->node.value = SysTick + ticks;
+    List_insertOrdered(&DelayedCoroutines, &co->node);
+}
+
+
+// Honor the request a coroutine returned with, called inside a critical section.
+static void applyRequest(Coroutine_t *co)
+{
+    uint32 ticks = co->node.value;
+
+    switch (co->request)
+    {
+        case CO_REQUEST_YIELD:
+            makeReady(co);
+            break;
+
+        case CO_REQUEST_DELAY:
+            co->state = CO_DELAYED;
+            delay(co, ticks);
+            break;
+
+        case CO_REQUEST_WAIT:
+            // Bits notified while it was running are received at once
+            if (co->notifyValue != 0)
+                receive(co);
+            else if (ticks == OS_NO_WAIT)
+            {
+                co->received = 0;
+                makeReady(co);
+            }
+            else
+            {
+                co->state = CO_WAITING;
+
+                if (ticks != OS_WAIT_FOREVER)
+                    delay(co, ticks);
+            }
+            break;
+
+        default:
+            co->resumePoint = 0;
+            co->state = CO_STOPPED;
+            break;
+    }
+}
+
+
+// Move the coroutines whose wake tick is reached to the ready list, called inside a critical section.
+// Returns the ticks to wait for the next one, OS_WAIT_FOREVER when none is delayed.
+static uint32 wakeDelayed(void)
+{
+    while (!LIST_IS_EMPTY(&DelayedCoroutines))
+    {
+        Coroutine_t *co = (Coroutine_t*)LIST_HEAD_OWNER(&DelayedCoroutines);
+        int32 ticksToWake = (int32)(co->node.value - SysTick);
+
+        if (ticksToWake > 0)
+            return (uint32)ticksToWake;
+
+        // A wait expiring gives nothing
+        if (co->state == CO_WAITING)
+            co->received = 0;
+
+        makeReady(co);
+    }
+
+    return OS_WAIT_FOREVER;
+}
+
+
+// Executor task, runs the ready coroutines one after the other on its stack
+static void Executor_Handler(void)
+{
+    while (1)
+    {
+        Coroutine_t *co;
+        uint32 ticksToWake;
+
+        DISABLE_INTERRUPTS();  // Enter critical section
+
+        ticksToWake = wakeDelayed();
+
+        if (LIST_IS_EMPTY(&ReadyCoroutines))
+        {
+            ENABLE_INTERRUPTS();
+
+            // Woken by a notification, a start or the next wake tick
+            (void)os_notifyTake(TRUE, ticksToWake);
+            continue;
+        }
+
+        co = (Coroutine_t*)LIST_HEAD_OWNER(&ReadyCoroutines);
+        List_remove(&co->node);
+        co->state = CO_RUNNING;
+
+        ENABLE_INTERRUPTS();	// Exit from critical section
+
+        // Returning without a suspending macro ends the coroutine
+        co->request = CO_REQUEST_EXIT;
+        co->function(co);
+
+        DISABLE_INTERRUPTS();
+        applyRequest(co);
+        ENABLE_INTERRUPTS();
+    }
+}
+
+
+// Create the executor task, called by os_init.
+void coroutinesInit(void)
+{
+    List_init(&ReadyCoroutines);
+    List_init(&DelayedCoroutines);
+
+    (void)OS_createTask(&Executor, &Executor_Handler, "COROUTINES", COROUTINE_EXECUTOR_PRIORITY, COROUTINE_STACK_SIZE);
+}
+
+
+// Set the bits and wake the coroutine if it waits for them, called inside a critical section.
+// Returns whether the executor has to be woken.
+static boolean notifyCoroutine(Coroutine_t *co, uint32 bits)
+{
+    co->notifyValue |= bits;
+
+    if (co->state != CO_WAITING)
+        return FALSE;
+
+    receive(co);
+
+    return TRUE;
+}
+
+
+OS_CoroutineError_t os_coroutineInit(Coroutine_t *co, osCoroutineFunc_t function, void *argument)
+{
+    if (co == NULL || function == NULL)
+        return OS_CO_INVALID;
+
+    co->function    = function;
+    co->argument    = argument;
+    co->notifyValue = 0;
+    co->received    = 0;
+    co->resumePoint = 0;
+    co->request     = CO_REQUEST_EXIT;
+    co->state       = CO_STOPPED;
+    List_initNode(&co->node, co);
+
+    return OS_CO_SUCCESS;
+}
+
+
+OS_CoroutineError_t os_coroutineStart(Coroutine_t *co)
+{
+    if (co == NULL || co->function == NULL)
+        return OS_CO_INVALID;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    if (co->state != CO_STOPPED)
+    {
+        ENABLE_INTERRUPTS();
+        return OS_CO_ACTIVE;
+    }
+
+    makeReady(co);
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    (void)os_notifyGive(Executor);
+
+    return OS_CO_SUCCESS;
+}
+
+
+OS_CoroutineError_t os_coroutineNotify(Coroutine_t *co, uint32 bits)
+{
+    boolean wake;
+
+    if (co == NULL || co->function == NULL)
+        return OS_CO_INVALID;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    wake = notifyCoroutine(co, bits);
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    if (wake)
+        (void)os_notifyGive(Executor);
+
+    return OS_CO_SUCCESS;
+}
+
+
+// os_coroutineNotify callable from an ISR.
+OS_CoroutineError_t os_coroutineNotifyFromISR(Coroutine_t *co, uint32 bits)
+{
+    uint32 interruptState;
+
+    if (co == NULL || co->function == NULL)
+        return OS_CO_INVALID;
+
+    interruptState = DISABLE_INTERRUPTS_FROM_ISR();
+
+    if (notifyCoroutine(co, bits))
+        (void)os_notifyGiveFromISR(Executor);
+
+    RESTORE_INTERRUPTS_FROM_ISR(interruptState);
+
+    return OS_CO_SUCCESS;
+}
+
+#endif
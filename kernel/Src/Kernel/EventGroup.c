@@ -0,0 +1,208 @@
+/**
+ ******************************************************************************
+ * File           : EventGroup.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Implementation of 32-bit event flag groups
+ ******************************************************************************
+ */
+
+#include <../Inc/LIB/std_types.h>
+#include <../Inc/LIB/common_macros.h>
+
+#include "../Inc/kernel/kernel_cfg.h"
+#include "../../Inc/kernel/port/port.h"
+#include "../../Inc/Kernel/EventGroup.h"
+#include "../../Inc/Kernel/kernel_private.h"
+
+
+extern Task_t Tasks[];
+extern volatile uint32 SysTick;
+
+
+// Check whether the flags of a group release a wait for bitsToWait
+static boolean isSatisfied(uint32 bits, uint32 bitsToWait, uint8 options)
+{
+    if (options & OS_EVENT_WAIT_ALL)
+        return ((bits & bitsToWait) == bitsToWait);
+
+    return ((bits & bitsToWait) != 0);
+}
+
+
+// Set flags and release the satisfied waiters, called inside a critical section.
+// Returns whether a released task should preempt the current task.
+static boolean setBits(EventGroup_t *group, uint32 bitsToSet)
+{
+    ListNode_t *node = group->waiters.head;
+    uint32 bitsToClear = 0;
+    boolean preempt = FALSE;
+
+    group->bits |= bitsToSet;
+
+    while (node != NULL)
+    {
+        Task_t *task = node->owner;
+
+        // Unblocking unlinks the node
+        node = node->next;
+
+        if (isSatisfied(group->bits, task->eventBits, task->eventOptions))
+        {
+            if (task->eventOptions & OS_EVENT_CLEAR_ON_EXIT)
+                bitsToClear |= task->eventBits;
+
+            // Report the flags that released the task
+            task->eventBits = group->bits;
+
+            preempt |= unblockTask(task);
+        }
+    }
+
+    // Every released waiter saw the flags before they are cleared
+    group->bits &= ~bitsToClear;
+
+    return preempt;
+}
+
+
+// Initialize an event group with all flags cleared.
+OS_EventError_t os_eventGroupCreate(EventGroup_t *group)
+{
+    if (group == NULL)
+        return OS_EVENT_INVALID;
+
+    group->bits = 0;
+    List_init(&group->waiters);
+
+    return OS_EVENT_SUCCESS;
+}
+
+
+// Wait up to timeout ticks for any or all (options) of the flags in bitsToWait.
+OS_EventError_t os_eventGroupWait(EventGroup_t *group, uint32 bitsToWait, uint8 options, uint32 timeout, uint32 *bits)
+{
+    Task_t *currentTask = &Tasks[Current_Task];
+    OS_EventError_t error = OS_EVENT_SUCCESS;
+    uint32 deadline = SysTick + timeout;
+    uint32 releaseBits;
+
+    if (group == NULL || bitsToWait == 0)
+        return OS_EVENT_INVALID;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    for (;;)
+    {
+        uint32 remaining = timeout;
+
+        if (isSatisfied(group->bits, bitsToWait, options))
+        {
+            releaseBits = group->bits;
+
+            if (options & OS_EVENT_CLEAR_ON_EXIT)
+                group->bits &= ~bitsToWait;
+
+            break;
+        }
+
+        // Wraparound-safe remaining time, the wait goes on after a wake-up without the flags
+        if (timeout != OS_WAIT_FOREVER)
+        {
+            remaining = deadline - SysTick;
+
+            if (timeout == OS_NO_WAIT || (int32)remaining <= 0)
+            {
+                releaseBits = group->bits;
+                error = OS_EVENT_TIMEOUT;
+                break;
+            }
+        }
+
+        // The setting side checks the request and releases the task
+        currentTask->eventBits    = bitsToWait;
+        currentTask->eventOptions = options;
+
+        blockOnEventList(&group->waiters, remaining);
+
+        ENABLE_INTERRUPTS();	// The context switch happens here
+        DISABLE_INTERRUPTS();
+
+        // Released with the flags that satisfied the wait, they may be cleared already
+        if (!currentTask->eventTimedOut)
+        {
+            releaseBits = currentTask->eventBits;
+            break;
+        }
+    }
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    if (bits != NULL)
+        *bits = releaseBits;
+
+    return error;
+}
+
+
+// Set flags and release the waiting tasks they satisfy.
+OS_EventError_t os_eventGroupSet(EventGroup_t *group, uint32 bitsToSet)
+{
+    boolean preempt;
+
+    if (group == NULL)
+        return OS_EVENT_INVALID;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    preempt = setBits(group, bitsToSet);
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    if (preempt)
+        enablePENDSV();
+
+    return OS_EVENT_SUCCESS;
+}
+
+
+// os_eventGroupSet callable from an ISR.
+OS_EventError_t os_eventGroupSetFromISR(EventGroup_t *group, uint32 bitsToSet)
+{
+    uint32 interruptState;
+
+    if (group == NULL)
+        return OS_EVENT_INVALID;
+
+    interruptState = DISABLE_INTERRUPTS_FROM_ISR();
+
+    // Only a task at or above the interrupted priority is worth a context switch
+    if (setBits(group, bitsToSet))
+        enablePENDSV();
+
+    RESTORE_INTERRUPTS_FROM_ISR(interruptState);
+
+    return OS_EVENT_SUCCESS;
+}
+
+
+// Clear flags, returns the flags before clearing.
+uint32 os_eventGroupClear(EventGroup_t *group, uint32 bitsToClear)
+{
+    uint32 interruptState = DISABLE_INTERRUPTS_FROM_ISR();
+    uint32 bits = group->bits;
+
+    group->bits &= ~bitsToClear;
+
+    RESTORE_INTERRUPTS_FROM_ISR(interruptState);
+
+    return bits;
+}
+
+
+// Current flags of the group.
+uint32 os_eventGroupGetBits(const EventGroup_t *group)
+{
+    return group->bits;
+}
@@ -0,0 +1,104 @@
+/**
+ ******************************************************************************
+ * File           : List.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Implementation of the intrusive doubly linked lists
+ ******************************************************************************
+ */
+
+#include <../Inc/LIB/std_types.h>
+#include <../Inc/LIB/common_macros.h>
+
+#include "../../Inc/Kernel/List.h"
+
+
+// Initialize an empty list.
+void List_init(List_t *list)
+{
+    list->head  = NULL;
+    list->tail  = NULL;
+    list->count = 0;
+}
+
+
+// Initialize an unlinked node owned by the specified object.
+void List_initNode(ListNode_t *node, void *owner)
+{
+    node->next      = NULL;
+    node->prev      = NULL;
+    node->container = NULL;
+    node->owner     = owner;
+    node->value     = 0;
+}
+
+
+// Append a node at the tail of a list, O(1).
+void List_insertTail(List_t *list, ListNode_t *node)
+{
+    node->next = NULL;
+    node->prev = list->tail;
+
+    if (list->tail != NULL)
+        list->tail->next = node;
+    else
+        list->head = node;
+
+    list->tail      = node;
+    node->container = list;
+    list->count++;
+}
+
+
+// Insert a node keeping the list in ascending order of value, after nodes of equal value.
+void List_insertOrdered(List_t *list, ListNode_t *node)
+{
+    ListNode_t *position = list->tail;
+
+    // Walk back from the tail, new deadlines are most likely the latest ones
+    while (position != NULL && (int32)(node->value - position->value) < 0)
+        position = position->prev;
+
+    // Link the node right after position, or at the head if there is none
+    node->prev = position;
+    node->next = (position != NULL) ? position->next : list->head;
+
+    if (node->next != NULL)
+        node->next->prev = node;
+    else
+        list->tail = node;
+
+    if (position != NULL)
+        position->next = node;
+    else
+        list->head = node;
+
+    node->container = list;
+    list->count++;
+}
+
+
+// Unlink a node from the list holding it, O(1). Unlinked nodes are ignored.
+void List_remove(ListNode_t *node)
+{
+    List_t *list = node->container;
+
+    if (list == NULL)
+        return;
+
+    if (node->prev != NULL)
+        node->prev->next = node->next;
+    else
+        list->head = node->next;
+
+    if (node->next != NULL)
+        node->next->prev = node->prev;
+    else
+        list->tail = node->prev;
+
+    node->next      = NULL;
+    node->prev      = NULL;
+    node->container = NULL;
+    list->count--;
+}
@@ -0,0 +1,196 @@
+/**
+ ******************************************************************************
+ * File           : Mutex.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Implementation of recursive mutexes with priority inheritance
+ ******************************************************************************
+ */
+
+#include <../Inc/LIB/std_types.h>
+#include <../Inc/LIB/common_macros.h>
+
+#include "../Inc/kernel/kernel_cfg.h"
+#include "../../Inc/kernel/port/port.h"
+#include "../../Inc/Kernel/Mutex.h"
+#include "../../Inc/Kernel/kernel_private.h"
+
+
+extern Task_t Tasks[];
+extern volatile uint32 SysTick;
+
+
+// Raise the owner to the priority of the highest priority waiter if it is above its own
+static void inheritPriority(Mutex_t *mutex)
+{
+    Task_t *topWaiter;
+
+    if (LIST_IS_EMPTY(&mutex->waiters))
+        return;
+
+    topWaiter = LIST_HEAD_OWNER(&mutex->waiters);
+
+    if (topWaiter->priority > mutex->owner->priority)
+        setTaskPriority(mutex->owner, topWaiter->priority);
+}
+
+
+// Lower the owner back after a waiter gave up, only when this is the single mutex it holds
+static void disinheritPriority(Mutex_t *mutex)
+{
+    Task_t *owner = mutex->owner;
+    uint32 priority = owner->basePriority;
+
+    if (owner->mutexesHeld != 1)
+        return;
+
+    if (!LIST_IS_EMPTY(&mutex->waiters) && ((Task_t*)LIST_HEAD_OWNER(&mutex->waiters))->priority > priority)
+        priority = ((Task_t*)LIST_HEAD_OWNER(&mutex->waiters))->priority;
+
+    if (priority != owner->priority)
+        setTaskPriority(owner, priority);
+}
+
+
+// Make a task the owner of a free mutex
+static void takeMutex(Mutex_t *mutex, Task_t *task)
+{
+    mutex->owner     = task;
+    mutex->lockCount = 1;
+    task->mutexesHeld++;
+}
+
+
+// Initialize a free mutex.
+OS_MutexError_t os_mutexCreate(Mutex_t *mutex)
+{
+    if (mutex == NULL)
+        return OS_MUTEX_INVALID;
+
+    mutex->owner     = NULL;
+    mutex->lockCount = 0;
+    List_init(&mutex->waiters);
+
+    return OS_MUTEX_SUCCESS;
+}
+
+
+// Lock the mutex, waiting up to timeout ticks if another task owns it.
+OS_MutexError_t os_mutexLock(Mutex_t *mutex, uint32 timeout)
+{
+    Task_t *currentTask = &Tasks[Current_Task];
+    uint32 deadline = SysTick + timeout;
+
+    if (mutex == NULL)
+        return OS_MUTEX_INVALID;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    // Recursive lock by the owner
+    if (mutex->owner == currentTask)
+    {
+        mutex->lockCount++;
+        ENABLE_INTERRUPTS();
+        return OS_MUTEX_SUCCESS;
+    }
+
+    // Wait until the unlocking owner hands the mutex over to this task
+    while (mutex->owner != currentTask)
+    {
+        uint32 remaining = timeout;
+
+        // Free, or freed while this task was out of the wait list (suspended)
+        if (mutex->owner == NULL)
+        {
+            takeMutex(mutex, currentTask);
+            break;
+        }
+
+        if (timeout == OS_NO_WAIT)
+        {
+            ENABLE_INTERRUPTS();
+            return OS_MUTEX_BUSY;
+        }
+
+        if (timeout != OS_WAIT_FOREVER)
+        {
+            remaining = deadline - SysTick;
+
+            if ((int32)remaining <= 0)
+            {
+                // The owner no longer needs to run at this task's priority
+                disinheritPriority(mutex);
+                ENABLE_INTERRUPTS();
+                return OS_MUTEX_TIMEOUT;
+            }
+        }
+
+        blockOnEventList(&mutex->waiters, remaining);
+
+        // Bound the priority inversion: the owner runs at least at our priority
+        inheritPriority(mutex);
+
+        ENABLE_INTERRUPTS();	// The context switch happens here
+        DISABLE_INTERRUPTS();
+    }
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    return OS_MUTEX_SUCCESS;
+}
+
+
+// Unlock the mutex, the highest priority waiter becomes the owner when the last lock is released.
+OS_MutexError_t os_mutexUnlock(Mutex_t *mutex)
+{
+    Task_t *currentTask = &Tasks[Current_Task];
+    boolean preempt = FALSE;
+
+    if (mutex == NULL)
+        return OS_MUTEX_INVALID;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    if (mutex->owner != currentTask)
+    {
+        ENABLE_INTERRUPTS();
+        return OS_MUTEX_NOT_OWNER;
+    }
+
+    if (--mutex->lockCount > 0)
+    {
+        ENABLE_INTERRUPTS();
+        return OS_MUTEX_SUCCESS;
+    }
+
+    currentTask->mutexesHeld--;
+
+    // Drop the inherited priority once no other mutex is held, a higher priority task may be ready now
+    if (currentTask->mutexesHeld == 0 && currentTask->priority != currentTask->basePriority)
+    {
+        setTaskPriority(currentTask, currentTask->basePriority);
+        preempt = TRUE;
+    }
+
+    if (LIST_IS_EMPTY(&mutex->waiters))
+        mutex->owner = NULL;
+    else
+    {
+        // Hand the mutex over to the highest priority waiter
+        Task_t *nextOwner = LIST_HEAD_OWNER(&mutex->waiters);
+
+        takeMutex(mutex, nextOwner);
+
+        preempt |= unblockTask(nextOwner);
+
+        inheritPriority(mutex);
+    }
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    if (preempt)
+        enablePENDSV();
+
+    return OS_MUTEX_SUCCESS;
+}
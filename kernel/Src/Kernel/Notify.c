@@ -0,0 +1,185 @@
+/**
+ ******************************************************************************
+ * File           : Notify.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Implementation of direct to task notifications
+ ******************************************************************************
+ */
+
+#include <../Inc/LIB/std_types.h>
+#include <../Inc/LIB/common_macros.h>
+
+#include "../Inc/kernel/kernel_cfg.h"
+#include "../../Inc/kernel/port/port.h"
+#include "../../Inc/Kernel/Notify.h"
+#include "../../Inc/Kernel/kernel_private.h"
+
+
+extern Task_t Tasks[];
+
+
+// Apply the action to the notification value and wake the task if it waits for it,
+// called inside a critical section. Returns whether the task should preempt the current task.
+static boolean notifyTask(Task_t *task, uint32 value, OS_NotifyAction_t action)
+{
+    boolean waiting = (task->notifyState == NOTIFY_WAITING);
+
+    switch (action)
+    {
+        case OS_NOTIFY_SET_BITS:    task->notifyValue |= value;  break;
+        case OS_NOTIFY_INCREMENT:   task->notifyValue++;         break;
+        case OS_NOTIFY_OVERWRITE:   task->notifyValue  = value;  break;
+    }
+
+    task->notifyState = NOTIFY_PENDING;
+
+    // The waiter is in no wait list, only its timeout has to be cancelled
+    if (!waiting)
+        return FALSE;
+
+    return unblockTask(task);
+}
+
+
+// Check the target of a notification, called inside a critical section.
+static boolean isNotifiable(const Task_t *task, OS_NotifyAction_t action)
+{
+    return (task != NULL && task->state != DELETED && action <= OS_NOTIFY_OVERWRITE);
+}
+
+
+OS_NotifyError_t os_notify(Task_Handler_t taskhandler, uint32 value, OS_NotifyAction_t action)
+{
+    boolean preempt;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    if (!isNotifiable(taskhandler, action))
+    {
+        ENABLE_INTERRUPTS();
+        return OS_NOTIFY_INVALID;
+    }
+
+    preempt = notifyTask(taskhandler, value, action);
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    if (preempt)
+        enablePENDSV();
+
+    return OS_NOTIFY_SUCCESS;
+}
+
+
+// os_notify callable from an ISR.
+OS_NotifyError_t os_notifyFromISR(Task_Handler_t taskhandler, uint32 value, OS_NotifyAction_t action)
+{
+    OS_NotifyError_t error = OS_NOTIFY_SUCCESS;
+    uint32 interruptState = DISABLE_INTERRUPTS_FROM_ISR();
+
+    if (!isNotifiable(taskhandler, action))
+        error = OS_NOTIFY_INVALID;
+
+    // Only a task at or above the interrupted priority is worth a context switch
+    else if (notifyTask(taskhandler, value, action))
+        enablePENDSV();
+
+    RESTORE_INTERRUPTS_FROM_ISR(interruptState);
+
+    return error;
+}
+
+
+OS_NotifyError_t os_notifyWait(uint32 clearOnEntry, uint32 clearOnExit, uint32 *value, uint32 timeout)
+{
+    Task_t *currentTask = &Tasks[Current_Task];
+    OS_NotifyError_t error = OS_NOTIFY_SUCCESS;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    if (currentTask->notifyState != NOTIFY_PENDING)
+    {
+        currentTask->notifyValue &= ~clearOnEntry;
+
+        if (timeout == OS_NO_WAIT)
+            error = OS_NOTIFY_EMPTY;
+        else
+        {
+            // The notifying side moves the task straight back to the ready list
+            currentTask->notifyState = NOTIFY_WAITING;
+
+            blockOnEventList(NULL, timeout);
+
+            ENABLE_INTERRUPTS();	// The context switch happens here
+            DISABLE_INTERRUPTS();
+
+            // Woken by the timeout or a resume
+            if (currentTask->notifyState != NOTIFY_PENDING)
+                error = OS_NOTIFY_TIMEOUT;
+        }
+    }
+
+    if (value != NULL)
+        *value = currentTask->notifyValue;
+
+    if (error == OS_NOTIFY_SUCCESS)
+        currentTask->notifyValue &= ~clearOnExit;
+
+    currentTask->notifyState = NOTIFY_NONE;
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    return error;
+}
+
+
+OS_NotifyError_t os_notifyGive(Task_Handler_t taskhandler)
+{
+    return os_notify(taskhandler, 0, OS_NOTIFY_INCREMENT);
+}
+
+
+OS_NotifyError_t os_notifyGiveFromISR(Task_Handler_t taskhandler)
+{
+    return os_notifyFromISR(taskhandler, 0, OS_NOTIFY_INCREMENT);
+}
+
+
+// os_notifyGive without the context switch, called by the tick inside a critical section.
+boolean notifyGiveFromTick(Task_t *task)
+{
+    return notifyTask(task, 0, OS_NOTIFY_INCREMENT);
+}
+
+
+uint32 os_notifyTake(boolean clearOnExit, uint32 timeout)
+{
+    Task_t *currentTask = &Tasks[Current_Task];
+    uint32 value;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    if (currentTask->notifyValue == 0 && timeout != OS_NO_WAIT)
+    {
+        currentTask->notifyState = NOTIFY_WAITING;
+
+        blockOnEventList(NULL, timeout);
+
+        ENABLE_INTERRUPTS();	// The context switch happens here
+        DISABLE_INTERRUPTS();
+    }
+
+    // Still 0 when the wait expired
+    value = currentTask->notifyValue;
+
+    if (value != 0)
+        currentTask->notifyValue = clearOnExit ? 0 : (value - 1);
+
+    currentTask->notifyState = NOTIFY_NONE;
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    return value;
+}
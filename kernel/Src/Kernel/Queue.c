@@ -0,0 +1,332 @@
+/**
+ ******************************************************************************
+ * File           : Queue.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Implementation of message queues
+ ******************************************************************************
+ */
+#include <string.h>
+
+#include <../Inc/LIB/std_types.h>
+#include <../Inc/LIB/common_macros.h>
+
+#include "../Inc/kernel/kernel_cfg.h"
+#include "../../Inc/kernel/port/port.h"
+#include "../../Inc/Kernel/Queue.h"
+#include "../../Inc/Kernel/kernel_private.h"
+
+
+extern volatile uint32 SysTick;
+
+
+// Check whether a slot can be written: none reserved and the ring is not full
+static boolean canWrite(const Queue_t *queue)
+{
+    return (!queue->reserved && (queue->acquired + queue->count) < queue->length);
+}
+
+// Check whether an element can be read: none acquired and the ring is not empty
+static boolean canRead(const Queue_t *queue)
+{
+    return (!queue->acquired && queue->count > 0);
+}
+
+// Address of the slot following the last element
+static uint8* getTailSlot(const Queue_t *queue)
+{
+    uint32 tail = queue->head + queue->acquired + queue->count;
+
+    if (tail >= queue->length)
+        tail -= queue->length;
+
+    return &queue->buffer[tail * queue->itemSize];
+}
+
+// Address of the oldest element
+static uint8* getHeadSlot(const Queue_t *queue)
+{
+    return &queue->buffer[queue->head * queue->itemSize];
+}
+
+// Free the head slot
+static void advanceHead(Queue_t *queue)
+{
+    if (++queue->head == queue->length)
+        queue->head = 0;
+}
+
+
+// Wake one receiver and one sender if the queue can now serve them, called inside a critical section.
+// Returns whether a woken task should preempt the current task.
+static boolean wakeWaiters(Queue_t *queue)
+{
+    boolean preempt = FALSE;
+
+    if (canRead(queue) && !LIST_IS_EMPTY(&queue->receiveWaiters))
+        preempt |= unblockTask(LIST_HEAD_OWNER(&queue->receiveWaiters));
+
+    if (canWrite(queue) && !LIST_IS_EMPTY(&queue->sendWaiters))
+        preempt |= unblockTask(LIST_HEAD_OWNER(&queue->sendWaiters));
+
+    return preempt;
+}
+
+
+// Wait inside the critical section until a slot (forSlot) or an element can be taken.
+// The critical section is left only while the task is blocked.
+static OS_QueueError_t waitForQueue(Queue_t *queue, boolean forSlot, uint32 timeout)
+{
+    uint32 deadline = SysTick + timeout;
+
+    while (forSlot ? !canWrite(queue) : !canRead(queue))
+    {
+        uint32 remaining = timeout;
+
+        if (timeout == OS_NO_WAIT)
+            return forSlot ? OS_QUEUE_FULL : OS_QUEUE_EMPTY;
+
+        // Wraparound-safe remaining time, another task may have taken what woke us
+        if (timeout != OS_WAIT_FOREVER)
+        {
+            remaining = deadline - SysTick;
+
+            if ((int32)remaining <= 0)
+                return OS_QUEUE_TIMEOUT;
+        }
+
+        blockOnEventList(forSlot ? &queue->sendWaiters : &queue->receiveWaiters, remaining);
+
+        ENABLE_INTERRUPTS();	// The context switch happens here
+        DISABLE_INTERRUPTS();
+    }
+
+    return OS_QUEUE_SUCCESS;
+}
+
+
+/* Function to create a message queue on caller supplied storage
+ Parameters:
+   - queue: Queue control block to initialize
+   - storage: Ring buffer of at least itemSize * length bytes
+   - itemSize: Size of one element in bytes
+   - length: Capacity of the queue in elements
+ Returns:
+   - OS_QueueError_t: Error code indicating the result of the operation */
+OS_QueueError_t os_queueCreate(Queue_t *queue, void *storage, uint32 itemSize, uint32 length)
+{
+    if (queue == NULL || storage == NULL || itemSize == 0 || length == 0)
+        return OS_QUEUE_INVALID;
+
+    queue->buffer   = (uint8*)storage;
+    queue->itemSize = itemSize;
+    queue->length   = length;
+    queue->head     = 0;
+    queue->count    = 0;
+    queue->reserved = FALSE;
+    queue->acquired = FALSE;
+
+    List_init(&queue->sendWaiters);
+    List_init(&queue->receiveWaiters);
+
+    return OS_QUEUE_SUCCESS;
+}
+
+
+// Copy an element to the back of the queue, waiting up to timeout ticks for a free slot.
+OS_QueueError_t os_queueSend(Queue_t *queue, const void *item, uint32 timeout)
+{
+    OS_QueueError_t error;
+    boolean preempt = FALSE;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    error = waitForQueue(queue, TRUE, timeout);
+
+    if (error == OS_QUEUE_SUCCESS)
+    {
+        memcpy(getTailSlot(queue), item, queue->itemSize);
+        queue->count++;
+
+        preempt = wakeWaiters(queue);
+    }
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    if (preempt)
+        enablePENDSV();
+
+    return error;
+}
+
+
+// Copy the element at the front of the queue out, waiting up to timeout ticks for one.
+OS_QueueError_t os_queueReceive(Queue_t *queue, void *item, uint32 timeout)
+{
+    OS_QueueError_t error;
+    boolean preempt = FALSE;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    error = waitForQueue(queue, FALSE, timeout);
+
+    if (error == OS_QUEUE_SUCCESS)
+    {
+        memcpy(item, getHeadSlot(queue), queue->itemSize);
+        advanceHead(queue);
+        queue->count--;
+
+        preempt = wakeWaiters(queue);
+    }
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    if (preempt)
+        enablePENDSV();
+
+    return error;
+}
+
+
+// Non blocking os_queueSend, callable from an ISR.
+OS_QueueError_t os_queueSendFromISR(Queue_t *queue, const void *item)
+{
+    uint32 interruptState = DISABLE_INTERRUPTS_FROM_ISR();
+
+    if (!canWrite(queue))
+    {
+        RESTORE_INTERRUPTS_FROM_ISR(interruptState);
+        return OS_QUEUE_FULL;
+    }
+
+    memcpy(getTailSlot(queue), item, queue->itemSize);
+    queue->count++;
+
+    // The switch is taken when the last ISR returns
+    if (wakeWaiters(queue))
+        enablePENDSV();
+
+    RESTORE_INTERRUPTS_FROM_ISR(interruptState);
+
+    return OS_QUEUE_SUCCESS;
+}
+
+
+// Non blocking os_queueReceive, callable from an ISR.
+OS_QueueError_t os_queueReceiveFromISR(Queue_t *queue, void *item)
+{
+    uint32 interruptState = DISABLE_INTERRUPTS_FROM_ISR();
+
+    if (!canRead(queue))
+    {
+        RESTORE_INTERRUPTS_FROM_ISR(interruptState);
+        return OS_QUEUE_EMPTY;
+    }
+
+    memcpy(item, getHeadSlot(queue), queue->itemSize);
+    advanceHead(queue);
+    queue->count--;
+
+    if (wakeWaiters(queue))
+        enablePENDSV();
+
+    RESTORE_INTERRUPTS_FROM_ISR(interruptState);
+
+    return OS_QUEUE_SUCCESS;
+}
+
+
+// Reserve the next free slot to be written in place, published by os_queueCommit.
+OS_QueueError_t os_queueReserve(Queue_t *queue, void **slot, uint32 timeout)
+{
+    OS_QueueError_t error;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    error = waitForQueue(queue, TRUE, timeout);
+
+    if (error == OS_QUEUE_SUCCESS)
+    {
+        *slot = getTailSlot(queue);
+        queue->reserved = TRUE;
+    }
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    return error;
+}
+
+
+// Publish the slot reserved by os_queueReserve to the receivers.
+void os_queueCommit(Queue_t *queue)
+{
+    boolean preempt = FALSE;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    if (queue->reserved)
+    {
+        // The reserved slot is the tail, counting it makes it the last element
+        queue->reserved = FALSE;
+        queue->count++;
+
+        preempt = wakeWaiters(queue);
+    }
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    if (preempt)
+        enablePENDSV();
+}
+
+
+// Acquire the element at the front of the queue to be read in place, freed by os_queueRelease.
+OS_QueueError_t os_queueAcquire(Queue_t *queue, void **slot, uint32 timeout)
+{
+    OS_QueueError_t error;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    error = waitForQueue(queue, FALSE, timeout);
+
+    if (error == OS_QUEUE_SUCCESS)
+    {
+        *slot = getHeadSlot(queue);
+        queue->acquired = TRUE;
+        queue->count--;
+    }
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    return error;
+}
+
+
+// Free the slot acquired by os_queueAcquire.
+void os_queueRelease(Queue_t *queue)
+{
+    boolean preempt = FALSE;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    if (queue->acquired)
+    {
+        queue->acquired = FALSE;
+        advanceHead(queue);
+
+        preempt = wakeWaiters(queue);
+    }
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    if (preempt)
+        enablePENDSV();
+}
+
+
+// Number of elements waiting in the queue.
+uint32 os_queueGetCount(const Queue_t *queue)
+{
+    return queue->count;
+}
@@ -0,0 +1,157 @@
+/**
+ ******************************************************************************
+ * File           : Semaphore.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Implementation of counting and binary semaphores
+ ******************************************************************************
+ */
+
+#include <../Inc/LIB/std_types.h>
+#include <../Inc/LIB/common_macros.h>
+
+#include "../Inc/kernel/kernel_cfg.h"
+#include "../../Inc/kernel/port/port.h"
+#include "../../Inc/Kernel/Semaphore.h"
+#include "../../Inc/Kernel/kernel_private.h"
+
+
+extern volatile uint32 SysTick;
+
+
+// Add a unit and wake the highest priority waiter, called inside a critical section.
+// Returns whether the woken task should preempt the current task.
+static boolean giveUnit(Semaphore_t *semaphore, OS_SemaphoreError_t *error)
+{
+    if (semaphore->count >= semaphore->maxCount)
+    {
+        *error = OS_SEMAPHORE_OVERFLOW;
+        return FALSE;
+    }
+
+    semaphore->count++;
+    *error = OS_SEMAPHORE_SUCCESS;
+
+    if (LIST_IS_EMPTY(&semaphore->waiters))
+        return FALSE;
+
+    return unblockTask(LIST_HEAD_OWNER(&semaphore->waiters));
+}
+
+
+// Initialize a semaphore holding initialCount units out of maxCount.
+OS_SemaphoreError_t os_semaphoreCreate(Semaphore_t *semaphore, uint32 initialCount, uint32 maxCount)
+{
+    if (semaphore == NULL || maxCount == 0 || initialCount > maxCount)
+        return OS_SEMAPHORE_INVALID;
+
+    semaphore->count    = initialCount;
+    semaphore->maxCount = maxCount;
+    List_init(&semaphore->waiters);
+
+    return OS_SEMAPHORE_SUCCESS;
+}
+
+
+// Take a unit, waiting up to timeout ticks for one.
+OS_SemaphoreError_t os_semaphoreTake(Semaphore_t *semaphore, uint32 timeout)
+{
+    uint32 deadline = SysTick + timeout;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    while (semaphore->count == 0)
+    {
+        uint32 remaining = timeout;
+
+        if (timeout == OS_NO_WAIT)
+        {
+            ENABLE_INTERRUPTS();
+            return OS_SEMAPHORE_EMPTY;
+        }
+
+        // Wraparound-safe remaining time, another task may have taken the unit that woke us
+        if (timeout != OS_WAIT_FOREVER)
+        {
+            remaining = deadline - SysTick;
+
+            if ((int32)remaining <= 0)
+            {
+                ENABLE_INTERRUPTS();
+                return OS_SEMAPHORE_TIMEOUT;
+            }
+        }
+
+        blockOnEventList(&semaphore->waiters, remaining);
+
+        ENABLE_INTERRUPTS();	// The context switch happens here
+        DISABLE_INTERRUPTS();
+    }
+
+    semaphore->count--;
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    return OS_SEMAPHORE_SUCCESS;
+}
+
+
+// Non blocking os_semaphoreTake, callable from an ISR.
+OS_SemaphoreError_t os_semaphoreTakeFromISR(Semaphore_t *semaphore)
+{
+    OS_SemaphoreError_t error = OS_SEMAPHORE_EMPTY;
+    uint32 interruptState = DISABLE_INTERRUPTS_FROM_ISR();
+
+    if (semaphore->count > 0)
+    {
+        semaphore->count--;
+        error = OS_SEMAPHORE_SUCCESS;
+    }
+
+    RESTORE_INTERRUPTS_FROM_ISR(interruptState);
+
+    return error;
+}
+
+
+// Give a unit back and wake the highest priority waiter.
+OS_SemaphoreError_t os_semaphoreGive(Semaphore_t *semaphore)
+{
+    OS_SemaphoreError_t error;
+    boolean preempt;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    preempt = giveUnit(semaphore, &error);
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    if (preempt)
+        enablePENDSV();
+
+    return error;
+}
+
+
+// os_semaphoreGive callable from an ISR.
+OS_SemaphoreError_t os_semaphoreGiveFromISR(Semaphore_t *semaphore)
+{
+    OS_SemaphoreError_t error;
+    uint32 interruptState = DISABLE_INTERRUPTS_FROM_ISR();
+
+    // Only a task at or above the interrupted priority is worth a context switch
+    if (giveUnit(semaphore, &error))
+        enablePENDSV();
+
+    RESTORE_INTERRUPTS_FROM_ISR(interruptState);
+
+    return error;
+}
+
+
+// Number of available units.
+uint32 os_semaphoreGetCount(const Semaphore_t *semaphore)
+{
+    return semaphore->count;
+}
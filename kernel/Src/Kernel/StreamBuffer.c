@@ -0,0 +1,362 @@
+/**
+ ******************************************************************************
+ * File           : StreamBuffer.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Implementation of the lock-free stream buffers
+ ******************************************************************************
+ */
+#include <string.h>
+
+#include <../Inc/LIB/std_types.h>
+#include <../Inc/LIB/common_macros.h>
+
+#include "../Inc/kernel/kernel_cfg.h"
+#include "../../Inc/kernel/port/port.h"
+#include "../../Inc/Kernel/Notify.h"
+#include "../../Inc/Kernel/StreamBuffer.h"
+#include "../../Inc/Kernel/kernel_private.h"
+
+
+extern Task_t Tasks[];
+extern volatile uint32 SysTick;
+
+
+// Bytes written and not read yet, the free running counters wrap together
+static uint32 getCount(const StreamBuffer_t *stream)
+{
+    return stream->tail - stream->head;
+}
+
+static uint32 getSpace(const StreamBuffer_t *stream)
+{
+    return stream->size - (stream->tail - stream->head);
+}
+
+
+// Notify the task blocked on the other end once, it checks the stream again when it wakes.
+// Only the interrupts masked to wake it are a critical section.
+static void wakeWaiter(Task_t * volatile *waiter, boolean fromISR)
+{
+    Task_t *task = *waiter;
+
+    // The waiter may give up on a timeout meanwhile, it then finds a stale notification and waits again
+    if (task == NULL || !ATOMIC_COMPARE_EXCHANGE(waiter, task, NULL))
+        return;
+
+    if (fromISR)
+        (void)os_notifyGiveFromISR(task);
+    else
+        (void)os_notifyGive(task);
+}
+
+
+// Whether the trigger level of bytes (reading) or a free byte (writing) is there. The trigger level
+// is read each time, a reader waiting for more than a new lower level is released by it.
+static boolean hasBytes(const StreamBuffer_t *stream, boolean reading)
+{
+    return reading ? (getCount(stream) >= stream->triggerLevel) : (getSpace(stream) != 0);
+}
+
+
+// Block the calling task on its notification until the trigger level of bytes (reading) or a free byte
+// (writing) is there, or timeout ticks after start. Returns whether it is.
+static boolean waitForBytes(StreamBuffer_t *stream, boolean reading, uint32 start, uint32 timeout)
+{
+    Task_t * volatile *waiter = reading ? &stream->reader : &stream->writer;
+
+    while (!hasBytes(stream, reading))
+    {
+        uint32 elapsed = SysTick - start, wait = timeout;
+
+        if (timeout != OS_WAIT_FOREVER)
+        {
+            if (elapsed >= timeout)
+                return FALSE;
+
+            wait = timeout - elapsed;
+        }
+
+        *waiter = &Tasks[Current_Task];
+
+        // Registered before the counters are read again, the other end moved before it could see the waiter
+        MEMORY_BARRIER();
+
+        if (hasBytes(stream, reading))
+        {
+            *waiter = NULL;
+            break;
+        }
+
+        (void)os_notifyTake(TRUE, wait);
+
+        *waiter = NULL;
+    }
+
+    return TRUE;
+}
+
+
+// Publish length bytes written at the tail and wake the reader once its trigger level is reached
+static void commit(StreamBuffer_t *stream, uint32 length, boolean fromISR)
+{
+    uint32 space = getSpace(stream);
+
+    if (length > space)
+        length = space;
+
+    if (length == 0)
+        return;
+
+    // The bytes are in the ring before the reader can see them
+    MEMORY_BARRIER();
+
+    stream->tail += length;
+
+    // Published before the reader is looked at
+    MEMORY_BARRIER();
+
+    if (getCount(stream) >= stream->triggerLevel)
+        wakeWaiter(&stream->reader, fromISR);
+}
+
+
+// Free length bytes read at the head and wake the writer
+static void release(StreamBuffer_t *stream, uint32 length, boolean fromISR)
+{
+    uint32 count = getCount(stream);
+
+    if (length > count)
+        length = count;
+
+    if (length == 0)
+        return;
+
+    // The bytes are read before the writer can overwrite them
+    MEMORY_BARRIER();
+
+    stream->head += length;
+
+    MEMORY_BARRIER();
+
+    wakeWaiter(&stream->writer, fromISR);
+}
+
+
+// Copy up to length bytes in at the tail, in two parts when the ring wraps
+static uint32 copyIn(StreamBuffer_t *stream, const uint8 *data, uint32 length, boolean fromISR)
+{
+    uint32 offset = stream->tail & (stream->size - 1);
+    uint32 space  = getSpace(stream), first;
+
+    if (length > space)
+        length = space;
+
+    // The space counted is read out before it is overwritten
+    MEMORY_BARRIER();
+
+    first = (length < stream->size - offset) ? length : (stream->size - offset);
+
+    memcpy(&stream->buffer[offset], data, first);
+    memcpy(stream->buffer, data + first, length - first);
+
+    commit(stream, length, fromISR);
+
+    return length;
+}
+
+
+// Copy up to maxLength bytes out at the head, in two parts when the ring wraps
+static uint32 copyOut(StreamBuffer_t *stream, uint8 *data, uint32 maxLength, boolean fromISR)
+{
+    uint32 offset = stream->head & (stream->size - 1);
+    uint32 length = getCount(stream), first;
+
+    if (length > maxLength)
+        length = maxLength;
+
+    // The bytes counted are in the ring before they are copied
+    MEMORY_BARRIER();
+
+    first = (length < stream->size - offset) ? length : (stream->size - offset);
+
+    memcpy(data, &stream->buffer[offset], first);
+    memcpy(data + first, stream->buffer, length - first);
+
+    release(stream, length, fromISR);
+
+    return length;
+}
+
+
+OS_StreamError_t os_streamCreate(StreamBuffer_t *stream, void *storage, uint32 size, uint32 triggerLevel)
+{
+    // A power of 2 keeps the offsets a mask of the free running counters
+    if (stream == NULL || storage == NULL || size == 0 || (size & (size - 1)) != 0 || size > 0x80000000UL)
+        return OS_STREAM_INVALID;
+
+    if (triggerLevel == 0 || triggerLevel > size)
+        return OS_STREAM_INVALID;
+
+    stream->buffer       = (uint8*)storage;
+    stream->size         = size;
+    stream->head         = 0;
+    stream->tail         = 0;
+    stream->triggerLevel = triggerLevel;
+    stream->reader       = NULL;
+    stream->writer       = NULL;
+
+    return OS_STREAM_SUCCESS;
+}
+
+
+OS_StreamError_t os_streamSetTriggerLevel(StreamBuffer_t *stream, uint32 triggerLevel)
+{
+    if (stream == NULL || triggerLevel == 0 || triggerLevel > stream->size)
+        return OS_STREAM_INVALID;
+
+    stream->triggerLevel = triggerLevel;
+
+    // A reader waiting for more than the new level may already have it
+    MEMORY_BARRIER();
+
+    if (getCount(stream) >= triggerLevel)
+        wakeWaiter(&stream->reader, FALSE);
+
+    return OS_STREAM_SUCCESS;
+}
+
+
+uint32 os_streamSend(StreamBuffer_t *stream, const void *data, uint32 length, uint32 timeout)
+{
+    uint32 start = SysTick, sent = 0;
+
+    if (stream == NULL || data == NULL)
+        return 0;
+
+    // Written as the reader frees space, all of it or until the wait expires
+    while (sent < length && waitForBytes(stream, FALSE, start, timeout))
+        sent += copyIn(stream, (const uint8*)data + sent, length - sent, FALSE);
+
+    return sent;
+}
+
+
+uint32 os_streamReceive(StreamBuffer_t *stream, void *data, uint32 maxLength, uint32 timeout)
+{
+    if (stream == NULL || data == NULL || maxLength == 0)
+        return 0;
+
+    // What arrived is returned when the wait expires
+    (void)waitForBytes(stream, TRUE, SysTick, timeout);
+
+    return copyOut(stream, (uint8*)data, maxLength, FALSE);
+}
+
+
+// Non blocking os_streamSend, callable from an ISR.
+uint32 os_streamSendFromISR(StreamBuffer_t *stream, const void *data, uint32 length)
+{
+    if (stream == NULL || data == NULL)
+        return 0;
+
+    return copyIn(stream, (const uint8*)data, length, TRUE);
+}
+
+
+// Non blocking os_streamReceive, callable from an ISR.
+uint32 os_streamReceiveFromISR(StreamBuffer_t *stream, void *data, uint32 maxLength)
+{
+    if (stream == NULL || data == NULL)
+        return 0;
+
+    return copyOut(stream, (uint8*)data, maxLength, TRUE);
+}
+
+
+// Get the contiguous free bytes at the tail of the ring to be written in place, published by os_streamCommit.
+uint32 os_streamReserve(StreamBuffer_t *stream, uint8 **data, uint32 timeout)
+{
+    uint32 offset, space;
+
+    if (stream == NULL || data == NULL)
+        return 0;
+
+    if (!waitForBytes(stream, FALSE, SysTick, timeout))
+        return 0;
+
+    offset = stream->tail & (stream->size - 1);
+    space  = getSpace(stream);
+
+    // The space counted is read out before it is written in place
+    MEMORY_BARRIER();
+
+    *data = &stream->buffer[offset];
+
+    // The free space past the end of the ring is reserved by the next call
+    return (space < stream->size - offset) ? space : (stream->size - offset);
+}
+
+
+void os_streamCommit(StreamBuffer_t *stream, uint32 length)
+{
+    if (stream != NULL)
+        commit(stream, length, FALSE);
+}
+
+
+void os_streamCommitFromISR(StreamBuffer_t *stream, uint32 length)
+{
+    if (stream != NULL)
+        commit(stream, length, TRUE);
+}
+
+
+// Get the contiguous bytes at the head of the ring to be read in place, freed by os_streamRelease.
+uint32 os_streamAcquire(StreamBuffer_t *stream, uint8 **data, uint32 timeout)
+{
+    uint32 offset, count;
+
+    if (stream == NULL || data == NULL)
+        return 0;
+
+    (void)waitForBytes(stream, TRUE, SysTick, timeout);
+
+    offset = stream->head & (stream->size - 1);
+    count  = getCount(stream);
+
+    // The bytes counted are in the ring before they are read in place
+    MEMORY_BARRIER();
+
+    *data = &stream->buffer[offset];
+
+    // The bytes wrapped to the start of the ring are acquired by the next call
+    return (count < stream->size - offset) ? count : (stream->size - offset);
+}
+
+
+void os_streamRelease(StreamBuffer_t *stream, uint32 length)
+{
+    if (stream != NULL)
+        release(stream, length, FALSE);
+}
+
+
+void os_streamReleaseFromISR(StreamBuffer_t *stream, uint32 length)
+{
+    if (stream != NULL)
+        release(stream, length, TRUE);
+}
+
+
+uint32 os_streamGetCount(const StreamBuffer_t *stream)
+{
+    return getCount(stream);
+}
+
+
+uint32 os_streamGetSpace(const StreamBuffer_t *stream)
+{
+    return getSpace(stream);
+}
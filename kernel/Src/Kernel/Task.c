@@ -15,78 +15,457 @@
 #include "../Inc/kernel/kernel_cfg.h"
 #include "../../Inc/kernel/port/port.h"
 #include "../../Inc/Kernel/Task.h"
+#include "../../Inc/Kernel/kernel_private.h"
 
 
 extern uint32 SysTick, App_Consumed_Stack;
+extern volatile boolean Kernel_Started;
 
-volatile Task_t Tasks[MAX_TASKS+1];
+#if RUNTIME_STATS == ENABLED
+extern volatile uint64 TotalRunTime;
+#endif
 
-volatile uint32 Current_Task, Task_counter;
+#if NUM_CORES > 1
+volatile uint32 CurrentTasks[NUM_CORES];
+#else
+volatile uint32 Current_Task;
+Task_t * volatile Current_TCB;
+#endif
+volatile uint32 Task_counter;
 
 
-/* Function to create a new task in the operating system
- Parameters:
-   - task_handler: Pointer to a task handler variable where the task control block pointer will be stored (optional)
-   - task_func: Pointer to the task function to be executed by the new task
-   - name: Name of the task
-   - priority: Priority level of the task
-   - stackSize: Size of the task's stack
- Returns:
-   - OS_TaskError_t: Error code indicating the result of the task creation operation */
-OS_TaskError_t OS_createTask(Task_Handler_t* task_handler, const osFunc_t task_func, const char* name, const uint32 priority, const uint32 stackSize)
+// Header written at the bottom of a free stack block
+typedef struct StackBlock_t
+{
+    struct StackBlock_t *next;  // Next free block of the same size class
+    uint32 size;                // Size of the block in bytes
+} StackBlock_t;
+
+// Stacks stay 8 bytes aligned as required by the procedure call standard
+#define STACK_ALIGNMENT             8
+#define ALIGN_STACK_SIZE(size)      (((size) + STACK_ALIGNMENT - 1) & ~(uint32)(STACK_ALIGNMENT - 1))
+
+// Stacks of deleted tasks, FreeStacks[n] holds the blocks of 2^n to 2^(n+1)-1 bytes
+static StackBlock_t *FreeStacks[32];
+
+// Indexes of the deleted task control blocks, used as a stack
+static uint32 FreeSlots[TASK_TABLE_SIZE];
+static uint32 FreeSlotsCount;
+
+
+#if STATIC_TASKS == ENABLED
+
+// Stack of a static task, at least a free block header as it joins the stack pool once deleted
+#define STATIC_STACK_WORDS(stackSize)   (ALIGN_STACK_SIZE(((stackSize) > sizeof(StackBlock_t)) ? (stackSize) : sizeof(StackBlock_t)) / sizeof(uint32))
+
+// The checks of createTask, made by the compiler
+#define STATIC_TASK_STACK(taskName, taskFunction, taskPriority, taskStackSize)                                  \
+    void taskFunction(void);                                                                                    \
+    typedef char taskName##_PriorityNotBelowMax[((taskPriority) < MAX_PRIORITIES) ? 1 : -1];                    \
+    typedef char taskName##_NameTooLong[((sizeof(#taskName) - 1) <= TASK_NAME_LEN) ? 1 : -1];                   \
+    static uint32 StaticStack_##taskName[STATIC_STACK_WORDS(taskStackSize)] __attribute__((aligned(STACK_ALIGNMENT)));
+
+#define STATIC_TASK_TCB(taskName, taskFunction, taskPriority, taskStackSize)                                    \
+    [OS_TASK_ID_##taskName] = {                                                                                 \
+        .psp          = &StaticStack_##taskName[STATIC_STACK_WORDS(taskStackSize)],                             \
+        .task_func    = &taskFunction,                                                                          \
+        .id           = OS_TASK_ID_##taskName,                                                                  \
+        .priority     = taskPriority,                                                                           \
+        .basePriority = taskPriority,                                                                           \
+        .stackSize    = sizeof(StaticStack_##taskName),                                                         \
+        .stackLimit   = StaticStack_##taskName,                                                                 \
+        .name         = #taskName,                                                                              \
+        .readyNode    = { .owner = (void*)&Tasks[OS_TASK_ID_##taskName] },                                      \
+        .delayNode    = { .owner = (void*)&Tasks[OS_TASK_ID_##taskName] },                                      \
+        .eventNode    = { .owner = (void*)&Tasks[OS_TASK_ID_##taskName] },                                      \
+        .affinity     = ALL_CORES,                                                                              \
+    },
+
+#define STATIC_TASK_HANDLE_DEF(taskName, taskFunction, taskPriority, taskStackSize)                             \
+    Task_Handler_t const OS_TaskHandle_##taskName = (Task_Handler_t)&Tasks[OS_TASK_ID_##taskName];
+
+OS_STATIC_TASKS(STATIC_TASK_STACK)
+
+// The control blocks of the static tasks are initialized data, the other ones are zeroed
+volatile Task_t Tasks[TASK_TABLE_SIZE] = { OS_STATIC_TASKS(STATIC_TASK_TCB) };
+
+OS_STATIC_TASKS(STATIC_TASK_HANDLE_DEF)
+
+#else
+
+volatile Task_t Tasks[TASK_TABLE_SIZE];
+
+#endif
+
+
+// Take a free task control block, a deleted one first so the scheduler scans fewer slots.
+// Returns NULL when every control block is in use. Called inside a critical section.
+static Task_t* allocateSlot(void)
 {
+    uint32 slot;
+
+    if (FreeSlotsCount > 0)
+        slot = FreeSlots[--FreeSlotsCount];
+    else if (Task_counter < TASK_TABLE_SIZE)
+        slot = Task_counter++;
+    else
+        return NULL;
+
+    Tasks[slot].id = slot;
+
+    return (Task_t*)&Tasks[slot];
+}
+
+// Give a task control block back to the allocator, called inside a critical section.
+static void releaseSlot(Task_t *task)
+{
+    FreeSlots[FreeSlotsCount++] = task->id;
+}
+
+
+// Take a stack of at least *stackSize bytes, a deleted task's one if one fits, or carve a new one
+// below the stacks in use. The size of the block is returned in *stackSize, NULL when no space is left.
+// Called inside a critical section.
+static uint32* allocateStack(uint32 *stackSize)
+{
+    StackBlock_t **freeList = NULL;
+    uint32 size, lowerClass, upperClass;
+
+    if (*stackSize > APP_STACK_SIZE)
+        return NULL;
+
+    size = ALIGN_STACK_SIZE((*stackSize > sizeof(StackBlock_t)) ? *stackSize : sizeof(StackBlock_t));
+    lowerClass = 31 - COUNT_LEADING_ZEROS(size);
+    upperClass = 32 - COUNT_LEADING_ZEROS(size - 1);
+
+    // The head of the lower class is the closest fit if it is large enough, every block of the upper class fits
+    if (FreeStacks[lowerClass] != NULL && FreeStacks[lowerClass]->size >= size)
+        freeList = &FreeStacks[lowerClass];
+    else if (upperClass < 32 && FreeStacks[upperClass] != NULL)
+        freeList = &FreeStacks[upperClass];
+
+    if (freeList != NULL)
+    {
+        StackBlock_t *block = *freeList;
+
+        *freeList  = block->next;
+        *stackSize = block->size;
+
+        return (uint32*)block;
+    }
+
+    if (size > APP_STACK_SIZE - App_Consumed_Stack)
+        return NULL;
+
+    App_Consumed_Stack += size;
+    *stackSize = size;
+
+    return (uint32*)(SRAM_END - App_Consumed_Stack);
+}
+
+// Link the stack of a deleted task in the free list of its size class, called inside a critical section.
+static void releaseStack(Task_t *task)
+{
+    StackBlock_t *block = (StackBlock_t*)task->stackLimit;
+    uint32 sizeClass = 31 - COUNT_LEADING_ZEROS(task->stackSize);
+
+    block->size = task->stackSize;
+    block->next = FreeStacks[sizeClass];
+    FreeStacks[sizeClass] = block;
+}
+
+
+#if STACK_PAINTING == ENABLED || STACK_OVERFLOW_CHECK == ENABLED
+
+// Fill the whole stack with the paint pattern, or only the canary at its bottom
+static void paintStack(Task_t *task)
+{
+    uint32 *bottom = GET_STACK_BOTTOM(task);
+
+#if STACK_PAINTING == ENABLED
+    uint32 words = GET_STACK_SIZE(task) / sizeof(uint32);
+#else
+    uint32 words = STACK_CANARY_WORDS;
+#endif
+
+    for (uint32 i = 0; i < words; i++)
+        bottom[i] = STACK_PAINT_PATTERN;
+}
+
+#endif
+
+
+// Give the control block and stack of a deleted task back to the allocator.
+void reclaimTask(Task_t *task)
+{
+    releaseStack(task);
+    releaseSlot(task);
+}
+
+
+// Entry of the periodic tasks: run the job once per period
+static void periodicTaskEntry(void)
+{
+    Task_t *task = (Task_t*)&Tasks[Current_Task];
+
+    while (1)
+    {
+        task->job();
+
+        (void)os_delayUntil((uint32*)&task->wakeTime, task->period);
+    }
+}
+
+
+#if STATIC_TASKS == ENABLED
+
+// Make the tasks of the static table ready, called by os_init once it created the kernel tasks.
+// Their control blocks are initialized data, only the initial stack frame is left to write.
+void staticTasksInit(void)
+{
+    Task_counter = OS_STATIC_TASKS_END;
+
+    for (uint32 id = KERNEL_TASK_COUNT; id < OS_STATIC_TASKS_END; id++)
+    {
+        Task_t *task = (Task_t*)&Tasks[id];
+
+#if STACK_PAINTING == ENABLED || STACK_OVERFLOW_CHECK == ENABLED
+        paintStack(task);
+#endif
+
+        initTaskStack(task);
+
+#if TRACE_RECORDER == ENABLED
+        traceTaskName(task);
+#endif
+        TRACE_RECORD(TRACE_TASK_CREATE, id, task->priority);
+
+        DISABLE_INTERRUPTS();
+        addToReadyList(task);
+        ENABLE_INTERRUPTS();
+    }
+}
+
+#endif
+
+
+// Create a task running task_func, periodic tasks run job every period ticks with a relative deadline (EDF)
+static OS_TaskError_t createTask(Task_Handler_t* task_handler, const osFunc_t task_func, const char* name, const uint32 priority,
+                                 const uint32 stackSize, const osFunc_t job, const uint32 period, const uint32 deadline)
+{
+    Task_t *task;
+    uint32 *stack;
+    uint32 blockSize = stackSize;
+    uint32 nameLength = strlen(name);
+    boolean preempt;
+
     // Error handling: Check if the task function pointer is NULL
     if (task_func == NULL)
         return OS_TASK_NULL_FUNC;
 
+    // Error handling: Check if the priority fits in the ready lists
+    if (priority >= MAX_PRIORITIES)
+        return OS_TASK_INVALID_PRIORITY;
+
     // Error handling: Check if the task name exceeds the maximum length
-    if (strlen(name) > TASK_NAME_LEN)
+    if (nameLength > TASK_NAME_LEN)
         return OS_TASK_LONG_NAME;
 
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    // Error handling: Check if a task control block is free
+    task = allocateSlot();
+    if (task == NULL)
+    {
+        ENABLE_INTERRUPTS();
+        return OS_TASK_NO_SLOT;
+    }
+
     // Error handling: Check if there is sufficient stack space available
-    if ((stackSize + App_Consumed_Stack) > (APP_STACK_SIZE - App_Consumed_Stack))
+    stack = allocateStack(&blockSize);
+    if (stack == NULL)
+    {
+        releaseSlot(task);
+        ENABLE_INTERRUPTS();
         return OS_TASK_STACK_OVERFLOW;
+    }
 
-    // Copy the task name into the task control block
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    // Copy the task name into the task control block, padded with terminators
     for (uint8 i = 0; i < TASK_NAME_LEN; i++)
-        Tasks[Task_counter].name[i] = name[i];
+        task->name[i] = (i < nameLength) ? name[i] : '\0';
 
     // Initialize task control block fields
-    Tasks[Task_counter].task_func = task_func;
-    Tasks[Task_counter].priority  = priority;
-    Tasks[Task_counter].psp       = (uint32*)(SRAM_END - App_Consumed_Stack);
-    Tasks[Task_counter].id		  = Task_counter;
-    Tasks[Task_counter].stackSize = stackSize;
-    Tasks[Task_counter].state     = READY;
+    task->task_func = task_func;
+    task->priority  = priority;
+    task->basePriority = priority;
+    task->mutexesHeld  = 0;
+    task->stackLimit   = stack;
+    task->stackSize    = blockSize;
+    task->psp       = (uint32*)((uint8*)stack + blockSize);
+    List_initNode(&task->readyNode, task);
+    List_initNode(&task->delayNode, task);
+    List_initNode(&task->eventNode, task);
+    task->notifyValue = 0;
+    task->notifyState = NOTIFY_NONE;
+    task->job       = job;
+    task->period    = period;
+    task->wakeTime  = SysTick;
+    task->overruns  = 0;
+    task->core      = THIS_CORE;
+    task->affinity  = ALL_CORES;
+    task->timeSlice = 0;
+
+#if SCHEDULE_ALGORITHM == EDF
+    task->relativeDeadline = deadline;
+    task->deadline         = task->wakeTime + deadline;
+    task->density          = 0;
+#else
+    (void)deadline;
+#endif
+
+#if RUNTIME_STATS == ENABLED
+    task->runTime     = 0;
+    task->switchCount = 0;
+    task->maxLatency  = 0;
+#endif
+
+#if STACK_PAINTING == ENABLED || STACK_OVERFLOW_CHECK == ENABLED
+    // Before the initial frame is written at the top
+    paintStack(task);
+#endif
 
     // Initialize task stack
-    initTaskStack(&Tasks[Task_counter]);
+    initTaskStack(task);
 
-    // Update consumed stack size and task counter
-    App_Consumed_Stack += stackSize;
-    ++Task_counter;
+#if TRACE_RECORDER == ENABLED
+    traceTaskName(task);
+#endif
+    TRACE_RECORD(TRACE_TASK_CREATE, task->id, priority);
 
     // If task_handler pointer is provided, store the task control block pointer
     if (task_handler != NULL)
-        *task_handler = &Tasks[Task_counter];
+        *task_handler = task;
+
+    // Make the task visible to the scheduler, the tick does not switch to a task created above the running one
+    DISABLE_INTERRUPTS();
+    addToReadyList(task);
+    preempt = (Kernel_Started && isPreemptedBy(task));
+    ENABLE_INTERRUPTS();
+
+    if (preempt)
+        enablePENDSV();
 
     // Return success
     return OS_TASK_SUCCESS;
 }
 
 
+/* Function to create a new task in the operating system
+ Parameters:
+   - task_handler: Pointer to a task handler variable where the task control block pointer will be stored (optional)
+   - task_func: Pointer to the task function to be executed by the new task
+   - name: Name of the task
+   - priority: Priority level of the task
+   - stackSize: Size of the task's stack
+ Returns:
+   - OS_TaskError_t: Error code indicating the result of the task creation operation */
+OS_TaskError_t OS_createTask(Task_Handler_t* task_handler, const osFunc_t task_func, const char* name, const uint32 priority, const uint32 stackSize)
+{
+    return createTask(task_handler, task_func, name, priority, stackSize, NULL, 0, 0);
+}
+
+
+// Create a task running job once every period ticks, the first time right away.
+OS_TaskError_t OS_createPeriodicTask(Task_Handler_t* task_handler, const osFunc_t job, const char* name, const uint32 priority,
+                                     const uint32 stackSize, const uint32 period)
+{
+    // Error handling: Check if the job function pointer is NULL
+    if (job == NULL)
+        return OS_TASK_NULL_FUNC;
+
+    // Error handling: Check if the period is at least one tick
+    if (period == 0)
+        return OS_TASK_INVALID_PERIOD;
+
+    return createTask(task_handler, &periodicTaskEntry, name, priority, stackSize, job, period, 0);
+}
+
+
+#if SCHEDULE_ALGORITHM == EDF
+
+// Sum of the densities of the deadline tasks in millionths
+static uint32 TotalDensity;
+
+OS_TaskError_t OS_createDeadlineTask(Task_Handler_t* task_handler, const osFunc_t job, const char* name, const uint32 stackSize,
+                                     const uint32 period, const uint32 deadline, const uint32 wcet)
+{
+    Task_Handler_t task;
+    OS_TaskError_t error;
+    uint32 window = (deadline < period) ? deadline : period;
+    uint32 density;
+
+    // Error handling: Check if the job function pointer is NULL
+    if (job == NULL)
+        return OS_TASK_NULL_FUNC;
+
+    // Error handling: Check if a job fits in its deadline and period
+    if (period == 0 || wcet == 0 || wcet > window)
+        return OS_TASK_INVALID_PERIOD;
+
+    // Rounded up so the admission test stays on the safe side
+    density = (uint32)(((uint64)wcet * 1000000 + window - 1) / window);
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    // Error handling: Check if every deadline can still be met
+    if (TotalDensity + density > 1000000)
+    {
+        ENABLE_INTERRUPTS();
+        return OS_TASK_NOT_SCHEDULABLE;
+    }
+
+    TotalDensity += density;
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    // Deadline tasks wait for kernel objects ahead of the other tasks
+    error = createTask(&task, &periodicTaskEntry, name, MAX_PRIORITIES - 1, stackSize, job, period, deadline);
+
+    DISABLE_INTERRUPTS();
+
+    if (error == OS_TASK_SUCCESS)
+        task->density = density;
+    else
+        TotalDensity -= density;
+
+    ENABLE_INTERRUPTS();
+
+    if (error == OS_TASK_SUCCESS && task_handler != NULL)
+        *task_handler = task;
+
+    return error;
+}
+
+#endif
+
+
 // To introduce a delay in the execution of the current task
 void os_delay(uint32 ticks)
 {
 	DISABLE_INTERRUPTS();  // Enter critical section
 
+    TRACE_RECORD(TRACE_TASK_DELAY, Current_Task, (ticks > 0xFFFF) ? 0xFFFF : ticks);
+
     // Set the state of the current task to BLOCKED
     // This indicates that the task is blocked and should not be scheduled until the delay expires
+    removeFromReadyList((Task_t*)&Tasks[Current_Task]);
     Tasks[Current_Task].state = BLOCKED;
 
     // Calculate the future tick value when the task will be unblocked
     // by adding the current SysTick value with the delay duration
-    Tasks[Current_Task].blockTicks = SysTick + ticks;
+    addToDelayList((Task_t*)&Tasks[Current_Task], SysTick + ticks);
 
     ENABLE_INTERRUPTS();	// Exit from critical section
 
@@ -94,31 +473,269 @@ void os_delay(uint32 ticks)
     enablePENDSV();
 }
 
+// Delay the current task until the next period after *lastWakeTime, wraparound-safe.
+uint32 os_delayUntil(uint32 *lastWakeTime, uint32 period)
+{
+    Task_t *task = (Task_t*)&Tasks[Current_Task];
+    uint32 wakeTick, lateTicks, missed = 0;
+
+    if (period == 0)
+        return 0;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    wakeTick  = *lastWakeTime + period;
+    lateTicks = SysTick - wakeTick;
+
+    // The wake tick already passed: skip the missed periods and stay in phase
+    if ((int32)lateTicks > 0)
+    {
+        missed = (lateTicks + period - 1) / period;
+        wakeTick += missed * period;
+        task->overruns += missed;
+    }
+
+    *lastWakeTime = wakeTick;
+
+    // Out of the ready structures while the deadline they may be ordered by changes
+    removeFromReadyList(task);
+
+#if SCHEDULE_ALGORITHM == EDF
+    // The next job is due relative to its release
+    task->deadline = wakeTick + task->relativeDeadline;
+#endif
+
+    // Run again right away when the wake tick is now, after the ready tasks it should yield to
+    if (wakeTick != SysTick)
+    {
+        TRACE_RECORD(TRACE_TASK_DELAY, Current_Task, ((wakeTick - SysTick) > 0xFFFF) ? 0xFFFF : (wakeTick - SysTick));
+
+        task->state = BLOCKED;
+        addToDelayList(task, wakeTick);
+    }
+    else
+        addToReadyList(task);
+
+    enablePENDSV();
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    return missed;
+}
+
+
+// Number of periods the task missed in os_delayUntil since it was created.
+uint32 os_getTaskOverruns(Task_Handler_t taskhandler)
+{
+    return taskhandler->overruns;
+}
+
+
 void os_suspendTask(Task_Handler_t taskhandler)
 {
-    if (taskhandler != NULL)
-    	if(taskhandler->state != DELETED)
-    		taskhandler->state = SUSPENDED;
+    if (taskhandler == NULL)
+        return;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    if(taskhandler->state != DELETED)
+    {
+        TRACE_RECORD(TRACE_TASK_SUSPEND, taskhandler->id, 0);
+
+        if(taskhandler->state == READY)
+            removeFromReadyList(taskhandler);
+
+        // A task waiting on a kernel object leaves its wait list, so no wake-up is handed to it while it
+        // cannot run. Once resumed it checks the object again for the rest of its timeout.
+        if(LIST_IS_LINKED(&taskhandler->eventNode))
+        {
+            List_remove(&taskhandler->eventNode);
+            removeFromDelayList(taskhandler);
+            taskhandler->eventTimedOut = TRUE;
+        }
+
+        taskhandler->state = SUSPENDED;
+    }
+
+    // A running task gives its core away right now, this one or another
+    if (TASK_IS_RUNNING(taskhandler))
+        preemptCore(taskhandler->core);
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
 }
 
 void os_resumeTask(Task_Handler_t taskhandler)
 {
-    if (taskhandler != NULL)
+    boolean preempt = FALSE;
+
+    if (taskhandler == NULL)
+        return;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    if(taskhandler->state == SUSPENDED)
     {
-    	if(taskhandler->state == SUSPENDED)
-    	{
-    		if(taskhandler->blockTicks <SysTick)
-    			taskhandler->state = READY;
-    		else
-    			taskhandler->state = BLOCKED;
-    	}
+        TRACE_RECORD(TRACE_TASK_RESUME, taskhandler->id, 0);
+
+        // A task suspended while delayed or waiting for a notification keeps waiting for the rest of its timeout
+        if(!LIST_IS_LINKED(&taskhandler->delayNode))
+        {
+            addToReadyList(taskhandler);
+            preempt = isPreemptedBy(taskhandler);
+        }
+        else
+            taskhandler->state = BLOCKED;
     }
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    if (preempt)
+        enablePENDSV();
 }
 
 void os_deleteTask(Task_Handler_t taskhandler)
 {
-    if (taskhandler != NULL)
-    	taskhandler->state = DELETED;
+    // The idle tasks always exist
+    if (taskhandler == NULL || taskhandler->id < NUM_CORES)
+        return;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    if(taskhandler->state != DELETED)
+    {
+        TRACE_RECORD(TRACE_TASK_DELETE, taskhandler->id, 0);
+
+        if(taskhandler->state == READY)
+            removeFromReadyList(taskhandler);
+
+        removeFromDelayList(taskhandler);
+        List_remove(&taskhandler->eventNode);
+
+        taskhandler->state = DELETED;
+
+#if SCHEDULE_ALGORITHM == EDF
+        TotalDensity -= taskhandler->density;
+        taskhandler->density = 0;
+#endif
+
+        // A running task still uses its stack, the scheduler of its core reclaims it after switching away
+        if (!TASK_IS_RUNNING(taskhandler))
+            reclaimTask(taskhandler);
+        else
+            preemptCore(taskhandler->core);
+    }
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+}
+
+
+OS_TaskError_t os_setTaskAffinity(Task_Handler_t taskhandler, uint32 coreMask)
+{
+    // The idle tasks stay on their core
+    if (taskhandler == NULL || taskhandler->id < NUM_CORES || (coreMask & ALL_CORES) == 0 || (coreMask & ~ALL_CORES) != 0)
+        return OS_TASK_INVALID_AFFINITY;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    taskhandler->affinity = coreMask;
+
+    // A blocked or suspended task is placed on an allowed core when it becomes ready
+    if (!(coreMask & (1UL << taskhandler->core)))
+    {
+        // Moved by the scheduler of its core once it switches away
+        if (TASK_IS_RUNNING(taskhandler))
+            preemptCore(taskhandler->core);
+        else if (taskhandler->state == READY)
+        {
+            removeFromReadyList(taskhandler);
+            addToReadyList(taskhandler);
+        }
+    }
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    return OS_TASK_SUCCESS;
+}
+
+
+void os_setTaskTimeSlice(Task_Handler_t taskhandler, uint32 ticks)
+{
+    if (taskhandler == NULL)
+        return;
+
+    // Read by the scheduler when the task starts a slice
+    taskhandler->timeSlice = ticks;
+}
+
+
+#if STACK_PAINTING == ENABLED
+
+// Peak number of stack bytes the task has used since it was created.
+uint32 os_getStackHighWaterMark(Task_Handler_t taskhandler)
+{
+    const uint32 *bottom = GET_STACK_BOTTOM(taskhandler);
+    uint32 words  = GET_STACK_SIZE(taskhandler) / sizeof(uint32);
+    uint32 unused = 0;
+
+    // The stack grows down, the paint left at the bottom was never reached
+    while (unused < words && bottom[unused] == STACK_PAINT_PATTERN)
+        unused++;
+
+    return (words - unused) * sizeof(uint32);
 }
 
+#endif
+
+
+#if RUNTIME_STATS == ENABLED
+
+uint32 os_getTaskStats(TaskStats_t *stats, uint32 maxTasks, uint32 *cpuLoad)
+{
+    // Totals at the previous call, the load is measured over the time in between
+    static uint64 lastTotalTime, lastIdleTime;
+    uint64 totalTime, idleTime, idleRunTime = 0;
+    uint32 count = 0;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    // Include the running task's current time slice
+    accountRunTime(getRunTimeCounter());
+
+    for (uint32 i = 0; i < Task_counter && count < maxTasks; i++)
+    {
+        Task_t *task = (Task_t*)&Tasks[i];
+
+        if (task->state == DELETED)
+            continue;
+
+        stats[count].id          = task->id;
+        stats[count].state       = task->state;
+        stats[count].priority    = task->priority;
+        stats[count].runTime     = task->runTime;
+        stats[count].switchCount = task->switchCount;
+        stats[count].maxLatency  = task->maxLatency;
+
+        for (uint8 j = 0; j < TASK_NAME_LEN; j++)
+            stats[count].name[j] = task->name[j];
+
+        count++;
+    }
+
+    // The idle tasks of the cores are the first ones
+    for (uint32 core = 0; core < NUM_CORES; core++)
+        idleRunTime += Tasks[core].runTime;
+
+    totalTime = TotalRunTime - lastTotalTime;
+    idleTime  = idleRunTime - lastIdleTime;
+    lastTotalTime = TotalRunTime;
+    lastIdleTime  = idleRunTime;
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    if (cpuLoad != NULL)
+        *cpuLoad = (totalTime > 0) ? (uint32)(10000 - (idleTime * 10000) / totalTime) : 0;
+
+    return count;
+}
 
+#endif
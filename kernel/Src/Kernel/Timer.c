@@ -0,0 +1,187 @@
+/**
+ ******************************************************************************
+ * File           : Timer.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Implementation of the software timers and their daemon task
+ ******************************************************************************
+ */
+
+#include <../Inc/LIB/std_types.h>
+#include <../Inc/LIB/common_macros.h>
+
+#include "../Inc/kernel/kernel_cfg.h"
+#include "../../Inc/kernel/port/port.h"
+#include "../../Inc/Kernel/Task.h"
+#include "../../Inc/Kernel/Notify.h"
+#include "../../Inc/Kernel/Timer.h"
+#include "../../Inc/Kernel/kernel_private.h"
+
+
+#if SOFTWARE_TIMERS == ENABLED
+
+extern volatile uint32 SysTick;
+
+
+// Active timers in ascending order of expiry tick
+static List_t ActiveTimers;
+
+static Task_Handler_t TimerDaemon;
+
+
+// Wraparound-safe, a timer reached late is still due
+#define TIMER_IS_DUE(timer)     ((int32)(SysTick - (timer)->node.value) >= 0)
+
+
+// Link a timer in the active timers until SysTick reaches expiry, called inside a critical section.
+static void activate(Timer_t *timer, uint32 expiry)
+{
+    List_remove(&timer->node);
+
+    timer->node.value = expiry;
+    List_insertOrdered(&ActiveTimers, &timer->node);
+}
+
+
+// Daemon task, runs the callbacks of the due timers each time the tick finds one
+static void TimerDaemon_Handler(void)
+{
+    while (1)
+    {
+        // The ticks reached since the last batch are taken at once
+        (void)os_notifyTake(TRUE, OS_WAIT_FOREVER);
+
+        DISABLE_INTERRUPTS();  // Enter critical section
+
+        while (!LIST_IS_EMPTY(&ActiveTimers))
+        {
+            Timer_t *timer = (Timer_t*)LIST_HEAD_OWNER(&ActiveTimers);
+            osTimerFunc_t function = timer->function;
+            void *argument = timer->argument;
+
+            if (!TIMER_IS_DUE(timer))
+                break;
+
+            List_remove(&timer->node);
+
+            // Next period from the expiry so it does not drift, from now once whole periods were missed
+            if (timer->autoReload)
+            {
+                uint32 expiry = timer->node.value + timer->period;
+
+                if ((int32)(SysTick - expiry) >= 0)
+                    expiry = SysTick + timer->period;
+
+                activate(timer, expiry);
+            }
+
+            // The callback may start or stop any timer, this one included
+            ENABLE_INTERRUPTS();
+            function(argument);
+            DISABLE_INTERRUPTS();
+        }
+
+        ENABLE_INTERRUPTS();	// Exit from critical section
+    }
+}
+
+
+// Create the daemon task, called by os_init.
+void timersInit(void)
+{
+    List_init(&ActiveTimers);
+
+    (void)OS_createTask(&TimerDaemon, &TimerDaemon_Handler, "TIMERS", TIMER_DAEMON_PRIORITY, TIMER_DAEMON_STACK_SIZE);
+}
+
+
+// Wake the daemon when the first timer is due, called every tick inside a critical section.
+boolean timersTick(void)
+{
+    if (!LIST_IS_EMPTY(&ActiveTimers) && TIMER_IS_DUE((Timer_t*)LIST_HEAD_OWNER(&ActiveTimers)))
+        return notifyGiveFromTick(TimerDaemon);
+
+    return FALSE;
+}
+
+
+// Ticks until the first timer is due, called by the tickless idle mode inside a critical section.
+uint32 timersIdleTicks(void)
+{
+    int32 ticksToExpiry;
+
+    if (LIST_IS_EMPTY(&ActiveTimers))
+        return 0xFFFFFFFF;
+
+    ticksToExpiry = (int32)(((Timer_t*)LIST_HEAD_OWNER(&ActiveTimers))->node.value - SysTick);
+
+    return (ticksToExpiry > 0) ? (uint32)ticksToExpiry : 0;
+}
+
+
+OS_TimerError_t os_timerInit(Timer_t *timer, osTimerFunc_t function, void *argument, boolean autoReload)
+{
+    if (timer == NULL || function == NULL)
+        return OS_TIMER_INVALID;
+
+    timer->function   = function;
+    timer->argument   = argument;
+    timer->period     = 0;
+    timer->autoReload = autoReload;
+    List_initNode(&timer->node, timer);
+
+    return OS_TIMER_SUCCESS;
+}
+
+
+OS_TimerError_t os_timerStart(Timer_t *timer, uint32 ticks)
+{
+    uint32 interruptState;
+
+    if (timer == NULL || timer->function == NULL || ticks == 0)
+        return OS_TIMER_INVALID;
+
+    interruptState = DISABLE_INTERRUPTS_FROM_ISR();
+
+    timer->period = ticks;
+    activate(timer, SysTick + ticks);
+
+    RESTORE_INTERRUPTS_FROM_ISR(interruptState);
+
+    return OS_TIMER_SUCCESS;
+}
+
+
+OS_TimerError_t os_timerReset(Timer_t *timer)
+{
+    if (timer == NULL)
+        return OS_TIMER_INVALID;
+
+    return os_timerStart(timer, timer->period);
+}
+
+
+OS_TimerError_t os_timerStop(Timer_t *timer)
+{
+    uint32 interruptState;
+
+    if (timer == NULL)
+        return OS_TIMER_INVALID;
+
+    interruptState = DISABLE_INTERRUPTS_FROM_ISR();
+
+    List_remove(&timer->node);
+
+    RESTORE_INTERRUPTS_FROM_ISR(interruptState);
+
+    return OS_TIMER_SUCCESS;
+}
+
+
+boolean os_timerIsActive(const Timer_t *timer)
+{
+    return (timer != NULL && LIST_IS_LINKED(&timer->node));
+}
+
+#endif
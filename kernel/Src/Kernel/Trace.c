@@ -0,0 +1,97 @@
+/**
+ ******************************************************************************
+ * File           : Trace.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Implementation of the kernel event trace recorder
+ ******************************************************************************
+ */
+
+#include <../Inc/LIB/std_types.h>
+#include <../Inc/LIB/common_macros.h>
+
+#include "../Inc/kernel/kernel_cfg.h"
+#include "../../Inc/kernel/port/port.h"
+#include "../../Inc/kernel/port/STK/STK_interface.h"
+#include "../../Inc/Kernel/Trace.h"
+#include "../../Inc/Kernel/kernel_private.h"
+
+
+#if TRACE_RECORDER == ENABLED
+
+#if (TRACE_BUFFER_LENGTH & (TRACE_BUFFER_LENGTH - 1)) != 0 || TRACE_BUFFER_LENGTH > 0xFFFF
+#error "TRACE_BUFFER_LENGTH must be a power of 2 below 65536"
+#endif
+
+
+extern volatile uint32 SysTick;
+
+TraceBuffer_t TraceBuffer =
+{
+    .magic        = TRACE_MAGIC,
+    .length       = TRACE_BUFFER_LENGTH,
+    .nameLength   = TASK_NAME_LEN,
+    .maxTasks     = TASK_TABLE_SIZE,
+    .tickMicroSec = SYSTEM_TICK * 1000
+};
+
+
+// Write a record in the ring, lock free so it can be called from any context.
+void traceRecord(uint8 event, uint8 task, uint16 data)
+{
+    // Claiming the slot is the only shared update, a nested recorder takes the next one
+    uint32 slot = ATOMIC_FETCH_INCREMENT(&TraceBuffer.written) & (TRACE_BUFFER_LENGTH - 1);
+    TraceRecord_t *record = &TraceBuffer.records[slot];
+    uint32 ticks, counts;
+
+    // Raw counts read inline rather than readTickTime, a record taken while the tick interrupt
+    // is pending is stamped up to a tick early
+    do
+    {
+        ticks  = SysTick;
+        counts = GET_TICK_ELAPSED_COUNTS();
+    }
+    while (ticks != SysTick);
+
+    record->timestamp = (ticks * TraceBuffer.countsPerTick) + counts;
+    record->event     = event;
+    record->task      = task;
+    record->data      = data;
+}
+
+
+// Record the timer counts of a tick once the tick is running, called by os_start.
+void traceStart(void)
+{
+    TraceBuffer.countsPerTick = STK_getIntervalCounts();
+}
+
+
+// Keep the name of a task for the host converter.
+void traceTaskName(const Task_t *task)
+{
+    for (uint8 i = 0; i < TASK_NAME_LEN; i++)
+        TraceBuffer.taskNames[task->id][i] = task->name[i];
+}
+
+
+void os_traceIsrEnter(uint16 irq)
+{
+    traceRecord(TRACE_ISR_ENTER, Current_Task, irq);
+}
+
+
+void os_traceIsrExit(uint16 irq)
+{
+    traceRecord(TRACE_ISR_EXIT, Current_Task, irq);
+}
+
+
+// Get the trace buffer to dump, sizeof(TraceBuffer_t) bytes.
+const TraceBuffer_t* os_traceGetBuffer(void)
+{
+    return &TraceBuffer;
+}
+
+#endif
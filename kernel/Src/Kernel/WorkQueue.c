@@ -0,0 +1,213 @@
+/**
+ ******************************************************************************
+ * File           : WorkQueue.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Portable
+ * Brief          : Implementation of the work queue and its daemon task
+ ******************************************************************************
+ */
+
+#include <../Inc/LIB/std_types.h>
+#include <../Inc/LIB/common_macros.h>
+
+#include "../Inc/kernel/kernel_cfg.h"
+#include "../../Inc/kernel/port/port.h"
+#include "../../Inc/Kernel/Task.h"
+#include "../../Inc/Kernel/Notify.h"
+#include "../../Inc/Kernel/WorkQueue.h"
+#include "../../Inc/Kernel/kernel_private.h"
+
+
+#if WORK_QUEUE == ENABLED
+
+#if (WORK_QUEUE_LENGTH & (WORK_QUEUE_LENGTH - 1)) != 0
+#error "WORK_QUEUE_LENGTH must be a power of 2"
+#endif
+
+
+// Slot of the ring, sequence tells whether it is free or published for the current lap
+typedef struct WorkSlot_t
+{
+    volatile uint32 sequence;       // position while free, position + 1 once published
+    Work_t * volatile work;
+} WorkSlot_t;
+
+
+static WorkSlot_t Ring[WORK_QUEUE_LENGTH];
+
+static volatile uint32 Tail;        // Next position claimed by a poster
+static uint32 Head;                 // Next position read by the daemon, only it writes it
+
+static WorkQueueStats_t Stats;
+
+static Task_Handler_t WorkDaemon;
+
+
+// Claim a slot and publish the work item in it, lock-free against nested posters.
+static boolean enqueue(Work_t *work)
+{
+    uint32 position = Tail, depth, mark;
+    WorkSlot_t *slot;
+
+    while (1)
+    {
+        slot = &Ring[position & (WORK_QUEUE_LENGTH - 1)];
+
+        // Free for this lap: try to claim it, a poster that interrupted us may have taken it first
+        if (slot->sequence == position)
+        {
+            if (ATOMIC_COMPARE_EXCHANGE(&Tail, position, position + 1))
+                break;
+        }
+        // Still holding the item of the previous lap, the ring is full
+        else if ((int32)(slot->sequence - position) < 0)
+            return FALSE;
+
+        position = Tail;
+    }
+
+    slot->work     = work;
+    slot->sequence = position + 1;
+
+    (void)ATOMIC_FETCH_INCREMENT(&Stats.posted);
+
+    // The daemon may not have freed the slots before ours yet, depth counts them
+    depth = position + 1 - Head;
+    mark  = Stats.highWaterMark;
+
+    while (depth > mark && !ATOMIC_COMPARE_EXCHANGE(&Stats.highWaterMark, mark, depth))
+        mark = Stats.highWaterMark;
+
+    return TRUE;
+}
+
+
+// Take the next published work item, NULL when the ring is empty or its head is not published yet.
+static Work_t* dequeue(void)
+{
+    WorkSlot_t *slot = &Ring[Head & (WORK_QUEUE_LENGTH - 1)];
+    Work_t *work;
+
+    if (slot->sequence != Head + 1)
+        return NULL;
+
+    work = slot->work;
+
+    // Free the slot for the next lap
+    slot->sequence = Head + WORK_QUEUE_LENGTH;
+    Head++;
+
+    return work;
+}
+
+
+// Mark the work item pending and queue it, the caller wakes the daemon on success.
+static OS_WorkError_t post(Work_t *work)
+{
+    if (work == NULL || work->function == NULL)
+        return OS_WORK_INVALID;
+
+    // Already waiting in the ring, it runs once for all the posts made until it starts
+    if (!ATOMIC_COMPARE_EXCHANGE(&work->pending, FALSE, TRUE))
+    {
+        (void)ATOMIC_FETCH_INCREMENT(&Stats.coalesced);
+        return OS_WORK_COALESCED;
+    }
+
+    if (!enqueue(work))
+    {
+        work->pending = FALSE;
+        (void)ATOMIC_FETCH_INCREMENT(&Stats.dropped);
+        return OS_WORK_FULL;
+    }
+
+    return OS_WORK_SUCCESS;
+}
+
+
+// Daemon task, runs every published work item each time it is notified
+static void WorkDaemon_Handler(void)
+{
+    while (1)
+    {
+        Work_t *work;
+
+        // All the posts since the last batch are taken at once
+        (void)os_notifyTake(TRUE, OS_WAIT_FOREVER);
+
+        Stats.batches++;
+
+        while ((work = dequeue()) != NULL)
+        {
+            osWorkFunc_t function = work->function;
+            void *argument = work->argument;
+
+            // Posted again from now on, it is queued again and runs once more
+            work->pending = FALSE;
+
+            function(argument);
+
+            Stats.executed++;
+        }
+    }
+}
+
+
+// Create the daemon task, called by os_init.
+void workQueueInit(void)
+{
+    for (uint32 i = 0; i < WORK_QUEUE_LENGTH; i++)
+        Ring[i].sequence = i;
+
+    (void)OS_createTask(&WorkDaemon, &WorkDaemon_Handler, "WORK_QUEUE", WORK_QUEUE_PRIORITY, WORK_QUEUE_STACK_SIZE);
+}
+
+
+OS_WorkError_t os_workInit(Work_t *work, osWorkFunc_t function, void *argument)
+{
+    if (work == NULL || function == NULL)
+        return OS_WORK_INVALID;
+
+    work->function = function;
+    work->argument = argument;
+    work->pending  = FALSE;
+
+    return OS_WORK_SUCCESS;
+}
+
+
+OS_WorkError_t os_workPost(Work_t *work)
+{
+    OS_WorkError_t error = post(work);
+
+    if (error == OS_WORK_SUCCESS)
+        (void)os_notifyGive(WorkDaemon);
+
+    return error;
+}
+
+
+// os_workPost callable from an ISR.
+OS_WorkError_t os_workPostFromISR(Work_t *work)
+{
+    OS_WorkError_t error = post(work);
+
+    if (error == OS_WORK_SUCCESS)
+        (void)os_notifyGiveFromISR(WorkDaemon);
+
+    return error;
+}
+
+
+// Get the work queue counters.
+void os_workQueueGetStats(WorkQueueStats_t *stats)
+{
+    if (stats == NULL)
+        return;
+
+    *stats = Stats;
+    stats->depth = Tail - Head;
+}
+
+#endif
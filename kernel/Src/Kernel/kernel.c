@@ -20,27 +20,314 @@
 
 #include "../../Inc/kernel/port/STK/STK_interface.h"
 #include "../../Inc/kernel/Task.h"
+#include "../../Inc/kernel/kernel_private.h"
 
 
 extern Task_t Tasks[];
-extern uint32 Current_Task, Task_counter;
+extern volatile uint32 Task_counter;
 volatile uint32 SysTick, App_Consumed_Stack = SCHEDULE_STACK_SIZE;
 
+// Set by os_start, the tasks created before only run once the first one is selected
+volatile boolean Kernel_Started;
+
+// Upper half of the 64-bit tick count, SysTick is the lower half
+static volatile uint32 TickHigh;
+
+// Odd while the tick count is being updated, readers retry when it changed
+static volatile uint32 TickSequence;
+
+// Delayed tasks in ascending order of wake tick
+static List_t DelayList;
+
+// Number of READY tasks, the idle task included
+static volatile uint32 ReadyTasks;
+
+#if TIME_SLICE_TICKS == 0
+#error "TIME_SLICE_TICKS must be at least 1"
+#endif
+
+// Ticks left in the time slice of the task running on every core, reloaded by schedule()
+static uint32 SliceTicksLeft[NUM_CORES];
+
+// Context switch requests of the tick handler
+static SwitchStats_t SwitchStats;
+
+#if SCHEDULE_ALGORITHM == PRIORITY_PREEMPTIVE || SCHEDULE_ALGORITHM == EDF
+
+#if MAX_PRIORITIES > 32
+#error "MAX_PRIORITIES must not exceed the 32 bits of the ready priorities bitmap"
+#endif
+
+// Ready tasks of every core and priority, round-robin order
+static List_t ReadyList[NUM_CORES][MAX_PRIORITIES];
+
+// Bit n is set while ReadyList[core][n] is not empty
+static volatile uint32 ReadyPriorities[NUM_CORES];
+
+#endif
+
+
+#if SCHEDULE_ALGORITHM == EDF
+
+// Ready deadline tasks, binary min-heap on the absolute deadline
+static Task_t *EdfHeap[TASK_TABLE_SIZE];
+static uint32 EdfHeapSize;
+
+// Wraparound-safe deadline order
+#define DEADLINE_BEFORE(a, b)       ((int32)((a)->deadline - (b)->deadline) < 0)
+
+
+// Store a task at a heap position
+static void placeInHeap(Task_t *task, uint32 index)
+{
+    EdfHeap[index]  = task;
+    task->heapIndex = index;
+}
+
+// Move the task at index up while its deadline is earlier than its parent's
+static void siftUp(uint32 index)
+{
+    Task_t *task = EdfHeap[index];
+
+    while (index > 0)
+    {
+        uint32 parent = (index - 1) / 2;
+
+        if (!DEADLINE_BEFORE(task, EdfHeap[parent]))
+            break;
+
+        placeInHeap(EdfHeap[parent], index);
+        index = parent;
+    }
+
+    placeInHeap(task, index);
+}
+
+// Move the task at index down while a child has an earlier deadline
+static void siftDown(uint32 index)
+{
+    Task_t *task = EdfHeap[index];
+
+    while (2 * index + 1 < EdfHeapSize)
+    {
+        uint32 child = 2 * index + 1;
+
+        if (child + 1 < EdfHeapSize && DEADLINE_BEFORE(EdfHeap[child + 1], EdfHeap[child]))
+            child++;
+
+        if (!DEADLINE_BEFORE(EdfHeap[child], task))
+            break;
+
+        placeInHeap(EdfHeap[child], index);
+        index = child;
+    }
+
+    placeInHeap(task, index);
+}
+
+static void insertInHeap(Task_t *task)
+{
+    EdfHeap[EdfHeapSize] = task;
+    siftUp(EdfHeapSize++);
+}
+
+static void removeFromHeap(Task_t *task)
+{
+    Task_t *last = EdfHeap[--EdfHeapSize];
+
+    // Fill the hole with the last task and restore the order around it
+    if (last != task)
+    {
+        placeInHeap(last, task->heapIndex);
+        siftUp(last->heapIndex);
+        siftDown(last->heapIndex);
+    }
+}
+
+#endif
+
+
+#if RUNTIME_STATS == ENABLED
+
+// Run time counter at the last context switch of every core
+static uint32 LastSwitchTime[NUM_CORES];
+
+// Microseconds charged to all the tasks, deleted ones included
+volatile uint64 TotalRunTime;
+
+
+// Microseconds counted from the tick and the SysTick timer, wraps every 71 minutes.
+uint32 getRunTimeCounter(void)
+{
+    return (uint32)os_getTimeUs();
+}
+
+
+// Charge the time since the last switch to the current task, called inside a critical section.
+void accountRunTime(uint32 now)
+{
+    uint32 elapsed = now - LastSwitchTime[THIS_CORE];
+
+    // The counter reads a tick behind while the tick interrupt is pending, keep the later reading
+    if ((int32)elapsed <= 0)
+        return;
+
+    Tasks[Current_Task].runTime += elapsed;
+    TotalRunTime += elapsed;
+    LastSwitchTime[THIS_CORE] = now;
+}
+
+
+// Count the switch in of the next task and its wait since it became ready
+static void recordSwitch(Task_t *previousTask, Task_t *nextTask, uint32 now)
+{
+    uint32 latency = now - nextTask->readyTime;
+
+    nextTask->switchCount++;
+
+    if ((int32)latency > 0 && latency > nextTask->maxLatency)
+        nextTask->maxLatency = latency;
+
+    // A preempted task starts waiting again
+    if (previousTask->state == READY)
+        previousTask->readyTime = now;
+}
+
+#endif
+
+
+#if STACK_OVERFLOW_CHECK == ENABLED
+
+// Halt so the debugger shows the task, the application may override it.
+WEAK void os_stackOverflowHook(Task_Handler_t taskhandler)
+{
+    (void)taskhandler;
+
+    DISABLE_INTERRUPTS();
+
+    while (1);
+}
+
+
+// Check the stack pointer saved for a switched out task against its limit and its canary
+static void checkStackOverflow(Task_t *task)
+{
+    const uint32 *bottom = GET_STACK_BOTTOM(task);
+    boolean overflow = (GET_SAVED_STACK_POINTER(task) < bottom + STACK_CANARY_WORDS);
+
+    for (uint32 i = 0; i < STACK_CANARY_WORDS; i++)
+        overflow |= (bottom[i] != STACK_PAINT_PATTERN);
+
+    if (overflow)
+        os_stackOverflowHook(task);
+}
+
+#endif
+
+
+#if TICKLESS_IDLE == ENABLED
+
+// Number of ticks the idle task may sleep, 0 when another task is ready to run
+static uint32 getIdleTicks(void)
+{
+    uint32 idleTicks = 0xFFFFFFFF;  // Nothing delayed, sleep as long as the timer allows
+
+    if (ReadyTasks > 1)
+        return 0;
+
+    if (!LIST_IS_EMPTY(&DelayList))
+    {
+        int32 ticksToWake = (int32)(((Task_t*)LIST_HEAD_OWNER(&DelayList))->blockTicks - SysTick);
+
+        idleTicks = (ticksToWake > 0) ? (uint32)ticksToWake : 0;
+    }
+
+    // The timer daemon must wake up on the tick of the next expiry
+#if SOFTWARE_TIMERS == ENABLED
+    if (timersIdleTicks() < idleTicks)
+        idleTicks = timersIdleTicks();
+#endif
+
+    return idleTicks;
+}
+
+
+// Stop the periodic tick, sleep until the next wakeup deadline and account for the skipped ticks.
+// The sleep is counted from the start of the tick it begins in and the tick it ends in keeps its length,
+// so the tick count follows the timer and the time read by readTickTime never goes backwards.
+static void suppressTicksAndSleep(void)
+{
+    uint32 idleTicks, sleptTicks, tickCounts, startCounts, sleptCounts;
+    uint32 maxIdleTicks = STK_getMaxInterval() / (SYSTEM_TICK * 1000);
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    idleTicks   = getIdleTicks();
+    tickCounts  = STK_getIntervalCounts();
+    startCounts = STK_getElapsedCounts();
+
+    // A tick that elapsed before its counts were read is counted by its interrupt first
+    if (idleTicks < TICKLESS_MIN_IDLE_TICKS || STK_isReloadPending())
+    {
+        ENABLE_INTERRUPTS();
+        return;
+    }
+
+    if (idleTicks > maxIdleTicks)
+        idleTicks = maxIdleTicks;
+
+    // Fire once at the deadline, any other interrupt wakes the CPU earlier
+    STK_setIntervalSingleCounts((idleTicks * tickCounts) - startCounts);
+
+    WAIT_FOR_INTERRUPT();
+
+    sleptCounts = startCounts + STK_stopIntervalSingle();
+    sleptTicks  = sleptCounts / tickCounts;
+
+    // The pending tick interrupt accounts for the last tick once interrupts are enabled
+    if (sleptCounts >= idleTicks * tickCounts)
+        sleptTicks--;
+
+    // Back to the periodic tick, the first reload ends the tick the CPU woke up in
+    STK_resumeIntervalPeriodic(tickCounts, tickCounts - (sleptCounts % tickCounts));
+
+    tickIncrement(sleptTicks);
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+}
+
+#endif
+
 
 // Handler for the Idle Task
 void IdleTask_Handler(void)
 {
     // Infinite loop to keep the idle task running
-    while (1);
+    while (1)
+    {
+#if TICKLESS_IDLE == ENABLED
+        suppressTicksAndSleep();
+#endif
+    }
 }
 
 void os_init()
 {
+    List_init(&DelayList);
+
+#if SCHEDULE_ALGORITHM == PRIORITY_PREEMPTIVE || SCHEDULE_ALGORITHM == EDF
+    for (uint32 core = 0; core < NUM_CORES; core++)
+        for (uint32 i = 0; i < MAX_PRIORITIES; i++)
+            List_init(&ReadyList[core][i]);
+#endif
+
     // Enable system faults if specified
 #if SYSTEM_FAULTS == ENABLED
     enableSystemFaults();
 #endif
 
+    initKernelInterrupts();
+
     STK_init();
 
     // Check if the schedule stack start address is different from SRAM end address
@@ -50,41 +337,454 @@ void os_init()
 #endif
 
 
-    // Create the idle task
-    (void)OS_createTask(NULL, &IdleTask_Handler, "IDLE_TASK", 0, 100);
+    // Create the idle task of every core, pinned to it, task IDs 0 .. NUM_CORES - 1
+    for (uint32 core = 0; core < NUM_CORES; core++)
+    {
+        Task_Handler_t idleTask;
+
+        (void)OS_createTask(&idleTask, &IdleTask_Handler, "IDLE_TASK", 0, IDLE_TASK_STACK_SIZE);
+
+        removeFromReadyList(idleTask);
+        idleTask->core     = core;
+        idleTask->affinity = 1UL << core;
+        addToReadyList(idleTask);
+
+        CURRENT_TASK_OF(core) = idleTask->id;
+    }
+
+    // Create the daemon running the work deferred by ISRs
+#if WORK_QUEUE == ENABLED
+    workQueueInit();
+#endif
+
+    // Create the daemon running the software timer callbacks
+#if SOFTWARE_TIMERS == ENABLED
+    timersInit();
+#endif
+
+    // Create the executor running the stackless coroutines
+#if COROUTINES == ENABLED
+    coroutinesInit();
+#endif
+
+    // Link the tasks built at compile time, their IDs follow the kernel tasks
+#if STATIC_TASKS == ENABLED
+    staticTasksInit();
+#endif
 }
 
 
-// Function to check and unblock tasks that are waiting for a certain number of ticks
-void checkBlockedTasks(void)
+// Function to unblock the delayed tasks whose wake tick has been reached, called every tick
+boolean checkBlockedTasks(void)
 {
+    boolean preempt = FALSE;
 
-	for (uint32 i = 0; i < Task_counter; i++)
+    // Only the expired tasks at the head of the sorted delay list are touched
+    while (!LIST_IS_EMPTY(&DelayList))
     {
-        if (Tasks[i].state == BLOCKED)
+        Task_t *task = LIST_HEAD_OWNER(&DelayList);
+
+        // Wraparound-safe, a tick reached late still wakes the task
+        if ((int32)(SysTick - task->blockTicks) < 0)
+            break;
+
+        List_remove(&task->delayNode);
+
+        // A task waiting on a kernel object gives up with a timeout
+        if (LIST_IS_LINKED(&task->eventNode))
         {
-            // If the task's block ticks have elapsed, change its state to READY
-            if (Tasks[i].blockTicks == SysTick)
-                Tasks[i].state = READY;
+            List_remove(&task->eventNode);
+            task->eventTimedOut = TRUE;
+        }
+
+        // A suspended task only leaves the list, os_resumeTask makes it ready
+        if (task->state == BLOCKED)
+        {
+            addToReadyList(task);
+            preempt |= isPreemptedBy(task);
         }
     }
+
+#if SOFTWARE_TIMERS == ENABLED
+    // The tick pends the switch, so a daemon woken by a due timer counts as a preemption
+    preempt |= timersTick();
+#endif
+
+    return preempt;
 }
 
 
-// Function to perform task scheduling and determine the next task to run
-void schedule()
+// Link a task in the delay list until SysTick reaches wakeTick, wraparound-safe.
+void addToDelayList(Task_t *task, uint32 wakeTick)
+{
+    task->blockTicks      = wakeTick;
+    task->delayNode.value = wakeTick;
+
+    List_insertOrdered(&DelayList, &task->delayNode);
+}
+
+
+// Unlink a task from the delay list if it is waiting in it.
+void removeFromDelayList(Task_t *task)
+{
+    List_remove(&task->delayNode);
+}
+
+
+// Block the current task on the wait list of a kernel object for up to timeout ticks
+// and pend a context switch, called inside a critical section. A NULL eventList waits
+// on the task itself (notifications).
+void blockOnEventList(List_t *eventList, uint32 timeout)
+{
+    Task_t *task = &Tasks[Current_Task];
+
+    removeFromReadyList(task);
+    task->state         = BLOCKED;
+    task->eventTimedOut = FALSE;
+
+    // Highest priority waiter first, FIFO among equal priorities
+    if (eventList != NULL)
+    {
+        task->eventNode.value = (MAX_PRIORITIES - 1) - task->priority;
+        List_insertOrdered(eventList, &task->eventNode);
+    }
+
+    if (timeout != OS_WAIT_FOREVER)
+        addToDelayList(task, SysTick + timeout);
+
+    // Taken as soon as the caller leaves the critical section
+    enablePENDSV();
+}
+
+
+// Take a task out of the wait list and delay list it is blocked in and make it ready,
+// returns whether it should preempt the current task. Called inside a critical section.
+boolean unblockTask(Task_t *task)
+{
+    List_remove(&task->eventNode);
+    removeFromDelayList(task);
+
+    // A suspended task becomes ready when it is resumed
+    if (task->state != BLOCKED)
+        return FALSE;
+
+    addToReadyList(task);
+
+    return isPreemptedBy(task);
+}
+
+
+// Change the effective priority of a task and move it in the ready list or wait list it is linked in,
+// called inside a critical section.
+void setTaskPriority(Task_t *task, uint32 priority)
+{
+    List_t *eventList = task->eventNode.container;
+
+    if (task->state == READY)
+    {
+        removeFromReadyList(task);
+        task->priority = priority;
+        addToReadyList(task);
+    }
+    else
+        task->priority = priority;
+
+    // Keep the wait list ordered by priority
+    if (eventList != NULL)
+    {
+        List_remove(&task->eventNode);
+        task->eventNode.value = (MAX_PRIORITIES - 1) - priority;
+        List_insertOrdered(eventList, &task->eventNode);
+    }
+}
+
+
+#if SCHEDULE_ALGORITHM == PRIORITY_PREEMPTIVE || SCHEDULE_ALGORITHM == EDF
+
+// Link a task at the tail of the ready list of its core and priority
+static void linkInReadyList(Task_t *task)
+{
+    List_insertTail(&ReadyList[task->core][task->priority], &task->readyNode);
+    ReadyPriorities[task->core] |= (1UL << task->priority);
+}
+
+static void unlinkFromReadyList(Task_t *task)
+{
+    List_remove(&task->readyNode);
+
+    if (LIST_IS_EMPTY(&ReadyList[task->core][task->priority]))
+        ReadyPriorities[task->core] &= ~(1UL << task->priority);
+}
+
+#endif
+
+
+#if NUM_CORES > 1
+
+// Core a task becomes ready on: its own core while it may run there and would preempt the task
+// running there, otherwise the allowed core running the lowest priority task, an idle one first.
+static uint32 selectCore(const Task_t *task)
+{
+    uint32 core = task->core;
+    uint32 lowestPriority;
+
+    if (task->affinity & (1UL << core))
+    {
+        // Still running there, its cache is warm
+        if (TASK_IS_RUNNING(task) || Tasks[CURRENT_TASK_OF(core)].priority < task->priority)
+            return core;
+    }
+    else
+        core = 31 - COUNT_LEADING_ZEROS(task->affinity);
+
+    lowestPriority = Tasks[CURRENT_TASK_OF(core)].priority;
+
+    for (uint32 i = 0; i < NUM_CORES; i++)
+    {
+        uint32 priority = Tasks[CURRENT_TASK_OF(i)].priority;
+
+        if ((task->affinity & (1UL << i)) && priority < lowestPriority)
+        {
+            core = i;
+            lowestPriority = priority;
+        }
+    }
+
+    return core;
+}
+
+
+// Move to a core left with its idle level only the highest priority task another core
+// has ready but is not running, the running tasks are never taken.
+static void stealTask(uint32 core)
+{
+    Task_t *stolen = NULL;
+
+    for (uint32 victim = 0; victim < NUM_CORES; victim++)
+    {
+        uint32 priorities = (victim != core) ? ReadyPriorities[victim] : 0;
+
+        // Levels from the highest, down to the level of the best task found so far
+        while (priorities != 0)
+        {
+            uint32 priority = 31 - COUNT_LEADING_ZEROS(priorities);
+
+            if (stolen != NULL && priority <= stolen->priority)
+                break;
+
+            for (ListNode_t *node = ReadyList[victim][priority].head; node != NULL; node = node->next)
+            {
+                Task_t *task = (Task_t*)node->owner;
+
+                if ((task->affinity & (1UL << core)) && !TASK_IS_RUNNING(task))
+                {
+                    stolen = task;
+                    break;
+                }
+            }
+
+            priorities &= ~(1UL << priority);
+        }
+    }
+
+    if (stolen != NULL)
+    {
+        unlinkFromReadyList(stolen);
+        stolen->core = core;
+        linkInReadyList(stolen);
+    }
+}
+
+#endif
+
+
+// Pend a context switch on a core, the calling one or another. Called inside a critical section.
+void preemptCore(uint32 core)
+{
+#if NUM_CORES > 1
+    if (core != THIS_CORE)
+    {
+        enableCorePENDSV(core);
+        return;
+    }
+#else
+    (void)core;
+#endif
+
+    enablePENDSV();
+}
+
+
+// Mark a task READY and link it in the ready structures of the selected scheduling algorithm.
+void addToReadyList(Task_t *task)
+{
+    task->state = READY;
+    ReadyTasks++;
+
+#if RUNTIME_STATS == ENABLED
+    task->readyTime = getRunTimeCounter();
+#endif
+
+#if SCHEDULE_ALGORITHM == EDF
+    if (task->relativeDeadline != 0)
+    {
+        insertInHeap(task);
+        return;
+    }
+#endif
+
+#if SCHEDULE_ALGORITHM == PRIORITY_PREEMPTIVE || SCHEDULE_ALGORITHM == EDF
+#if NUM_CORES > 1
+    task->core = selectCore(task);
+#endif
+
+    linkInReadyList(task);
+
+#if NUM_CORES > 1
+    // Another core picks it up right away when it runs a lower priority task
+    if (task->core != THIS_CORE && task->priority > Tasks[CURRENT_TASK_OF(task->core)].priority)
+        preemptCore(task->core);
+#endif
+#endif
+}
+
+
+// Unlink a READY task from the ready structures, the caller sets the new state.
+void removeFromReadyList(Task_t *task)
+{
+    ReadyTasks--;
+
+#if SCHEDULE_ALGORITHM == EDF
+    if (task->relativeDeadline != 0)
+    {
+        removeFromHeap(task);
+        return;
+    }
+#endif
+
+#if SCHEDULE_ALGORITHM == PRIORITY_PREEMPTIVE || SCHEDULE_ALGORITHM == EDF
+    unlinkFromReadyList(task);
+#else
+    (void)task;
+#endif
+}
+
+
+// Check whether a task that just became ready should preempt the current task.
+boolean isPreemptedBy(const Task_t *task)
+{
+#if SCHEDULE_ALGORITHM == PRIORITY_PREEMPTIVE
+#if NUM_CORES > 1
+    // Ready on another core, addToReadyList already pended it
+    if (task->core != THIS_CORE)
+        return FALSE;
+#endif
+
+    // An equal priority task waits for the end of the time slice, only the idle task gives way to it
+    return (task->priority > Tasks[Current_Task].priority || Current_Task == 0);
+#elif SCHEDULE_ALGORITHM == EDF
+    const Task_t *currentTask = &Tasks[Current_Task];
+
+    // Deadline tasks come first, the earliest deadline among them
+    if (task->relativeDeadline != 0)
+        return (currentTask->relativeDeadline == 0 || DEADLINE_BEFORE(task, currentTask));
+
+    return (currentTask->relativeDeadline == 0 && (task->priority > currentTask->priority || Current_Task == 0));
+#else
+    // Round-robin rotates at the end of the time slice, only the idle task gives way at once
+    (void)task;
+    return (Current_Task == 0);
+#endif
+}
+
+
+// Ticks of a time slice of the task
+static uint32 getTimeSlice(const Task_t *task)
+{
+    return (task->timeSlice != 0) ? task->timeSlice : TIME_SLICE_TICKS;
+}
+
+
+// Check whether another task would take over a core at the end of the time slice of its running task
+static boolean isSliceContended(uint32 core)
+{
+    const Task_t *currentTask = &Tasks[CURRENT_TASK_OF(core)];
+
+#if NUM_CORES == 1
+    (void)core;
+#endif
+
+#if SCHEDULE_ALGORITHM == ROUND_ROBIN
+    // Every READY task takes turns, the running one and the idle task included in the count
+    return (ReadyTasks > ((currentTask->id == 0) ? 1 : 2));
+#else
+#if SCHEDULE_ALGORITHM == EDF
+    // Deadline tasks run in deadline order, never sliced
+    if (currentTask->relativeDeadline != 0)
+        return FALSE;
+#endif
+#if NUM_CORES > 1
+    // An idle core steals a task waiting on a busy one, the idle tasks and the running tasks are READY too
+    if (currentTask->id < NUM_CORES)
+    {
+        uint32 readyOrRunning = NUM_CORES;
+
+        for (uint32 i = 0; i < NUM_CORES; i++)
+        {
+            if (CURRENT_TASK_OF(i) >= NUM_CORES)
+                readyOrRunning++;
+        }
+
+        return (ReadyTasks > readyOrRunning);
+    }
+#endif
+    // Another task at the level of the running one, higher ones have already preempted it
+    return (currentTask->readyNode.container != NULL && currentTask->readyNode.container->count > 1);
+#endif
+}
+
+
+// Charge a tick to the time slice of the task running on a core, called by the tick handler inside a critical section.
+// Returns whether the core needs a context switch: preempted by a task the tick woke, or its slice ended with a task to take over.
+boolean tickSwitchRequired(uint32 core, boolean preempted)
 {
-    // Calculate the index of the next task in the task list
-    uint32 nextTask = (Current_Task + 1) % Task_counter;
+    boolean sliceEnded = FALSE;
+
+    // 0 until the first schedule() of the core
+    if (SliceTicksLeft[core] > 0 && --SliceTicksLeft[core] == 0)
+    {
+        sliceEnded = isSliceContended(core);
 
+        // Alone at its level, the task starts another slice without a context switch
+        if (!sliceEnded)
+            SliceTicksLeft[core] = getTimeSlice(&Tasks[CURRENT_TASK_OF(core)]);
+    }
+
+    if (preempted || sliceEnded)
+    {
+        SwitchStats.tickSwitches++;
+        return TRUE;
+    }
+
+    SwitchStats.avoidedSwitches++;
+    return FALSE;
+}
+
+
+// Select the next task to run in Current_Task
+static void selectNextTask(void)
+{
     // Perform task scheduling based on the selected scheduling algorithm from kernel_cfg.h
     #if SCHEDULE_ALGORITHM == ROUND_ROBIN
 
+    uint32 nextTask = Current_Task;
+
     // Iterate through the task list to find the next ready task in round-robin
-    for (uint32 i = 0; i < Task_counter; i++, nextTask++)
+    for (uint32 i = 0; i < Task_counter; i++)
     {
-        // Wrap around the task index if it exceeds the number of tasks
-        nextTask %= Task_counter;
+        // Next task index, wrapped around without a division
+        if (++nextTask >= Task_counter)
+            nextTask = 0;
 
         // Skip the task index 0 (the idle task), in case there are another ready tasks to execute
         if (!nextTask)
@@ -102,10 +802,188 @@ void schedule()
     // If no ready task is found, set the current task to the idle task (index 0)
     Current_Task = 0;
 
+    #else
+
+    uint32 core = THIS_CORE;
+    Task_t *currentTask = &Tasks[CURRENT_TASK_OF(core)];
+
+    #if SCHEDULE_ALGORITHM == EDF
+    // The earliest deadline, ahead of the tasks without one
+    if (EdfHeapSize > 0)
+    {
+        Current_Task = EdfHeap[0]->id;
+        return;
+    }
+    #endif
+
+    #if NUM_CORES > 1
+    // Nothing above the idle level here, help a busy core
+    if (ReadyPriorities[core] <= 1UL)
+        stealTask(core);
+    #endif
+
+    // Highest ready priority in constant time, the idle task keeps the bitmap non zero
+    uint32 topPriority = 31 - COUNT_LEADING_ZEROS(ReadyPriorities[core]);
+    List_t *readyList  = &ReadyList[core][topPriority];
+    ListNode_t *next   = readyList->head;
+
+    // Round-robin among equal priorities: continue after the current task if it is still at this level
+    if (currentTask->readyNode.container == readyList && currentTask->readyNode.next != NULL)
+        next = currentTask->readyNode.next;
+
+    CURRENT_TASK_OF(core) = ((Task_t*)next->owner)->id;
+
     #endif
 }
 
 
+// Function to perform task scheduling and determine the next task to run
+void schedule()
+{
+    Task_t *previousTask = &Tasks[Current_Task];
+
+#if STACK_OVERFLOW_CHECK == ENABLED
+    // A task that deleted itself no longer owns its stack
+    if (previousTask->state != DELETED)
+        checkStackOverflow(previousTask);
+#endif
+
+#if RUNTIME_STATS == ENABLED
+    uint32 now = getRunTimeCounter();
+
+    accountRunTime(now);
+#endif
+
+#if NUM_CORES > 1
+    // A task whose affinity no longer includes this core moves to an allowed one
+    if (previousTask->state == READY && !(previousTask->affinity & (1UL << THIS_CORE)))
+    {
+        removeFromReadyList(previousTask);
+        addToReadyList(previousTask);
+    }
+#endif
+
+    selectNextTask();
+
+#if RUNTIME_STATS == ENABLED
+    if (previousTask != &Tasks[Current_Task])
+        recordSwitch(previousTask, &Tasks[Current_Task], now);
+#endif
+
+    if (previousTask != &Tasks[Current_Task])
+        TRACE_RECORD(TRACE_TASK_SWITCH, Current_Task, previousTask->id);
+
+    // A task switched in or at the end of its slice starts a new one, a preemption it survived keeps the rest
+    if (previousTask != &Tasks[Current_Task] || SliceTicksLeft[THIS_CORE] == 0)
+        SliceTicksLeft[THIS_CORE] = getTimeSlice(&Tasks[Current_Task]);
+
+    // A task that deleted itself is no longer running on its stack
+    if (previousTask->state == DELETED && previousTask != &Tasks[Current_Task])
+        reclaimTask(previousTask);
+
+#if NUM_CORES == 1
+    Current_TCB = &Tasks[Current_Task];
+#endif
+}
+
+
+
+// Number of ticks since os_start, wraps around.
+uint32 os_getTickCount(void)
+{
+    return SysTick;
+}
+
+
+// Advance the tick count, called by the tick handler and after a tickless sleep.
+void tickIncrement(uint32 ticks)
+{
+    // A reader interrupting the update would wait for it forever
+    uint32 interruptState = DISABLE_INTERRUPTS_FROM_ISR();
+
+    TickSequence++;
+
+    if (SysTick + ticks < SysTick)
+        TickHigh++;
+
+    SysTick += ticks;
+
+    // The timer counts of the next tick start from the reloads counted
+    STK_countReloads(ticks);
+
+    TickSequence++;
+
+    RESTORE_INTERRUPTS_FROM_ISR(interruptState);
+}
+
+
+// Read the tick count and the timer counts elapsed since that tick as one consistent pair.
+void readTickTime(uint64 *ticks, uint32 *counts)
+{
+    uint32 sequence, high, low, elapsed;
+
+    do
+    {
+        sequence = TickSequence;
+        high     = TickHigh;
+        low      = SysTick;
+        elapsed  = STK_getElapsedCounts();
+
+        // The timer reloaded but the tick was not counted yet, its counts restarted from 0
+        if (STK_isReloadPending())
+            elapsed = STK_getElapsedCounts() + STK_getIntervalCounts();
+    }
+    while ((sequence & 1) || sequence != TickSequence);
+
+    *ticks  = ((uint64)high << 32) | low;
+    *counts = elapsed;
+}
+
+
+// Nanoseconds since os_start, monotonic.
+uint64 os_getTimeNs(void)
+{
+    uint64 ticks;
+    uint32 counts;
+
+    readTickTime(&ticks, &counts);
+
+    return (ticks * (SYSTEM_TICK * 1000000ULL)) + STK_countsToNs(counts);
+}
+
+
+// Microseconds since os_start, monotonic.
+uint64 os_getTimeUs(void)
+{
+    uint64 ticks;
+    uint32 counts;
+
+    readTickTime(&ticks, &counts);
+
+    return (ticks * (SYSTEM_TICK * 1000ULL)) + STK_countsToMicroSec(counts);
+}
+
+
+// Core the caller is running on.
+uint32 os_getCoreId(void)
+{
+    return THIS_CORE;
+}
+
+
+// Get the context switch counters of the tick handler.
+void os_getSwitchStats(SwitchStats_t *stats)
+{
+    if (stats == NULL)
+        return;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    *stats = SwitchStats;
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+}
+
 
 void os_start()
 {
@@ -113,6 +991,12 @@ void os_start()
     // The interval is defined by the SYSTEM_TICK constant (kernel_cfg.h), converted to microseconds
     STK_setIntervalPeriodic(SYSTEM_TICK * 1000);
 
+#if TRACE_RECORDER == ENABLED
+    traceStart();
+#endif
+
+    Kernel_Started = TRUE;
+
     // Execute the scheduling algorithm to determine the next task to run
     schedule();
 
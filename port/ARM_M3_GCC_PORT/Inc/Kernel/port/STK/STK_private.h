@@ -20,6 +20,12 @@ typedef struct
 
 #define STK ((volatile STK_t *) 0xE000E010)
 
+// Interrupt control and state register of the SCB, holds the SysTick pending bit
+#define STK_ICSR              (*(volatile uint32*)0xE000ED04)
+#define STK_ICSR_PENDSTCLR    (1UL << 25)
+
+#define STK_MAX_LOAD          0x00FFFFFF
+
 #define STK_AHB               0
 #define STK_AHB_DIV8          1
 
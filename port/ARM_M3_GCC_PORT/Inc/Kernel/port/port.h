@@ -16,6 +16,11 @@
 #include "../kernel_interface.h"
 #include "../Task.h"
 
+// The STM32F10x has a single Cortex-M3 core
+#if NUM_CORES > 1
+#error "The ARM_M3_GCC_PORT runs a single core, set NUM_CORES to 1"
+#endif
+
 #ifndef SHCSR
 #define SHCSR		    		 (*(volatile uint32*)0xE000ED24)
 #endif
@@ -24,6 +29,18 @@
 #define ICSR					 (*(volatile uint32*)0xE000ED04)
 #endif
 
+#ifndef SHPR3
+#define SHPR3					 (*(volatile uint32*)0xE000ED20)
+#endif
+
+#ifndef SYST_RVR
+#define SYST_RVR				 (*(volatile uint32*)0xE000E014)
+#endif
+
+#ifndef SYST_CVR
+#define SYST_CVR				 (*(volatile uint32*)0xE000E018)
+#endif
+
 #ifndef SRAM_END
 #define SRAM_END				 ( 0x20000000 + (1024 * 20) )
 #endif
@@ -33,30 +50,112 @@
 #define DUMMY_LR				 (0xFFFFFFFD)
 
 
-#define DISABLE_INTERRUPTS() 	 do{ __asm__ volatile ("cpsid i"); } while(0)
-#define ENABLE_INTERRUPTS()  	 do{ __asm__ volatile ("cpsie i"); } while(0)
+// The STM32F10x implements the upper 4 bits of the interrupt priorities
+#define NVIC_PRIO_BITS			 4
+
+#if MAX_SYSCALL_INTERRUPT_PRIORITY < 1 || MAX_SYSCALL_INTERRUPT_PRIORITY >= (1 << NVIC_PRIO_BITS)
+#error "MAX_SYSCALL_INTERRUPT_PRIORITY must be 1 .. 15, BASEPRI 0 masks nothing"
+#endif
+
+// BASEPRI masking the interrupts that may call the kernel, those of a higher priority stay enabled
+#define BASEPRI_SYSCALL			 (MAX_SYSCALL_INTERRUPT_PRIORITY << (8 - NVIC_PRIO_BITS))
+
+// PendSV and SysTick run below every interrupt
+#define KERNEL_INTERRUPT_PRIORITY (0xFF)
+
+
+// Kernel critical sections raise BASEPRI and nest, only the outermost one lowers it again
+#define DISABLE_INTERRUPTS() 	 enterCritical()
+#define ENABLE_INTERRUPTS()  	 exitCritical()
+
+// Mask the kernel interrupts from an ISR, returns the previous BASEPRI to restore (nests with DISABLE_INTERRUPTS)
+#define DISABLE_INTERRUPTS_FROM_ISR()        disableInterruptsFromISR()
+#define RESTORE_INTERRUPTS_FROM_ISR(state)   restoreInterruptsFromISR(state)
+
+// Sleep until an interrupt is pending. WFI ignores the interrupts masked by BASEPRI,
+// so they are masked by PRIMASK for the sleep, a pending one wakes the core and waits for ENABLE_INTERRUPTS.
+#define WAIT_FOR_INTERRUPT()	 do{ __asm__ volatile ("cpsid i \n msr basepri, %0 \n dsb \n wfi \n isb \n msr basepri, %1 \n cpsie i" \
+                                                       :: "r" (0), "r" (BASEPRI_SYSCALL) : "memory"); } while(0)
+
+// Number of leading zero bits of a non zero word, a single CLZ instruction
+#define COUNT_LEADING_ZEROS(x)	 ((uint32)__builtin_clz(x))
+
+// Add one to a uint32 without masking interrupts, returns the value before, a LDREX/STREX loop
+#define ATOMIC_FETCH_INCREMENT(variable)   __atomic_fetch_add((variable), 1, __ATOMIC_RELAXED)
+
+// Write desired to a uint32 if it still holds expected without masking interrupts, returns whether it did, a LDREX/STREX loop
+#define ATOMIC_COMPARE_EXCHANGE(variable, expected, desired)   __sync_bool_compare_and_swap((variable), (expected), (desired))
+
+// Order the memory accesses before it against the ones after it, for the CPU, the compiler and the DMA
+#define MEMORY_BARRIER()                   __asm__ volatile ("dmb" ::: "memory")
+
+// Memory a task runs on and the stack pointer saved when it was switched out
+#define GET_STACK_BOTTOM(task)               ((uint32*)(task)->stackLimit)
+#define GET_STACK_SIZE(task)                 ((task)->stackSize)
+#define GET_SAVED_STACK_POINTER(task)        ((uint32*)(task)->psp)
 
 #define enablePENDSV()		     SET_BIT(ICSR,28)
 
+// SysTick counts elapsed in the current tick, read inline for timestamps like STK_getElapsedCounts.
+// CVR reads 0 for a count after the reload, that tick already ended and is counted as pending.
+#define GET_TICK_ELAPSED_COUNTS()	 getTickElapsedCounts()
 
+static inline uint32 getTickElapsedCounts(void)
+{
+    uint32 value = SYST_CVR;
 
-void initTaskStack( Task_t *taskHandler);
+    return (value != 0) ? (SYST_RVR - value) : 0;
+}
 
-void NAKED initScheduleStack(uint32 scheduleStackAddress);
 
-void NAKED saveContext(void);
 
-void NAKED retrieveContext(void);
+// Depth of the kernel critical sections. The kernel interrupts only run while it is 0, so they find it at 0
+// and leave it at 0, BASEPRI is raised before it is incremented and lowered after it is decremented.
+extern volatile uint32 CriticalNesting;
 
-void NAKED turnToPSP(void);
 
-void savePSP(uint32* psp);
+static inline void enterCritical(void)
+{
+    __asm__ volatile ("MSR BASEPRI, %0 \n isb" :: "r" (BASEPRI_SYSCALL) : "memory");
 
-void enableSystemFaults(void);
+    CriticalNesting++;
+}
+
+static inline void exitCritical(void)
+{
+    if (--CriticalNesting == 0)
+        __asm__ volatile ("MSR BASEPRI, %0 \n isb" :: "r" (0) : "memory");
+}
+
+static inline uint32 disableInterruptsFromISR(void)
+{
+    uint32 basepri;
+
+    __asm__ volatile ("MRS %0, BASEPRI \n MSR BASEPRI, %1 \n isb" : "=&r" (basepri) : "r" (BASEPRI_SYSCALL) : "memory");
+
+    // A critical section inside keeps the mask up to the restore
+    CriticalNesting++;
+
+    return basepri;
+}
 
-uint32* getCurrentTaskPSP();
+static inline void restoreInterruptsFromISR(uint32 basepri)
+{
+    CriticalNesting--;
+
+    __asm__ volatile ("MSR BASEPRI, %0" :: "r" (basepri) : "memory");
+}
+
+
+void initTaskStack( Task_t *taskHandler);
+
+void NAKED initScheduleStack(uint32 scheduleStackAddress);
+
+void NAKED turnToPSP(void);
+
+void enableSystemFaults(void);
 
-uint32* getNextTaskPSP();
+void initKernelInterrupts(void);
 
 
 
@@ -9,6 +9,7 @@
 #include <../Inc/LIB/common_macros.h>
 #include <../Inc/LIB/std_types.h>
 
+#include <Kernel/port/port.h>
 #include <Kernel/port/STK/STK_config.h>
 #include <Kernel/port/STK/STK_interface.h>
 #include <Kernel/port/STK/STK_private.h>
@@ -17,19 +18,35 @@
 #define CPU_INPUT_CLOCK RCC_AHB_CLK_FRQ
 #endif
 
-static volatile float32 microSecToTicksRatio = 0;
+#if STK_CLOCK_PRESCALER == STK_AHB_DIV8
+#define STK_COUNT_FREQUENCY       (CPU_INPUT_CLOCK / 8)
+#else
+#define STK_COUNT_FREQUENCY       (CPU_INPUT_CLOCK)
+#endif
+
+// Conversions between timer counts and time in fixed point, the scales are computed by the compiler
+// so a conversion is a multiply and a shift. Two intervals of counts (25 bits) times a scale fit in 64 bits.
+#define STK_SCALE_SHIFT           24
+#define NS_PER_COUNT_SCALED       ((1000000000ULL << STK_SCALE_SHIFT) / STK_COUNT_FREQUENCY)
+#define US_PER_COUNT_SCALED       ((1000000ULL << STK_SCALE_SHIFT) / STK_COUNT_FREQUENCY)
+#define COUNTS_PER_US_SCALED      (((uint64)STK_COUNT_FREQUENCY << STK_SCALE_SHIFT) / 1000000)
+
+
+// Set once the timer reached zero and kept until the kernel counts the tick: reading CTRL clears COUNTFLAG,
+// and PENDSTSET clears when the SysTick exception is taken, before its handler counted the tick.
+static volatile uint8 reloadSeen = FALSE;
+
+
+// Number of timer counts of an interval in microseconds.
+static uint32 microSecToCounts(uint32 NoMicroSec)
+{
+    return (uint32)(((uint64)NoMicroSec * COUNTS_PER_US_SCALED) >> STK_SCALE_SHIFT);
+}
 
 
 // Initialize the SysTick timer.
 void STK_init ()
 {
-    // Set number of Ticks for one microsecond.
-     microSecToTicksRatio = (float32)CPU_INPUT_CLOCK / 1000000;
-     
-    #if STK_CLOCK_PRESCALER == STK_AHB_DIV8
-    microSecToTicksRatio = microSecToTicksRatio / 8;
-    #endif 
-    
     /*Enable SysTick*/
     STK->CTRL=0b1;
 
@@ -51,11 +68,83 @@ void STK_setIntervalPeriodic ( uint32 NoMicroSec )
     SET_BIT(STK->CTRL,1);
 
     //Load number of ticks to Load Register.
-    STK->LOAD = (NoMicroSec *microSecToTicksRatio);
+    STK->LOAD = microSecToCounts(NoMicroSec);
+
+    // Restart counting from the new period.
+    STK->VAL  = 0;
     
 }
 
 
+// Restart the SysTick timer so it interrupts once after a specified number of timer counts.
+void STK_setIntervalSingleCounts ( uint32 counts )
+{
+    // Stop counting, a reload since the caller read the elapsed counts is part of the new interval.
+    CLR_BIT(STK->CTRL,0);
+    STK_ICSR = STK_ICSR_PENDSTCLR;
+    reloadSeen = FALSE;
+
+    // Load number of ticks, writing VAL restarts the count and clears COUNTFLAG.
+    STK->LOAD = counts;
+    STK->VAL  = 0;
+
+    // Enable Interrupt and SYSTick.
+    SET_BIT(STK->CTRL,1);
+    SET_BIT(STK->CTRL,0);
+}
+
+
+// Stop the interval loaded by STK_setIntervalSingleCounts and get the counts elapsed since it was loaded.
+uint32 STK_stopIntervalSingle(void)
+{
+    // Reading CTRL clears COUNTFLAG, it is checked again once the counter stopped.
+    uint32 control = STK->CTRL;
+    uint32 value, elapsed;
+
+    STK->CTRL = control & ~1UL;
+    value     = STK->VAL;
+
+    // VAL is zero before the first count and for the count the timer reached zero at
+    elapsed = (value == 0) ? 0 : (STK->LOAD - value);
+
+    // The counter reached zero and restarted from LOAD, its interrupt is pending. A reader of the time may have
+    // cleared COUNTFLAG before, it kept the reload in reloadSeen.
+    if (reloadSeen || GET_BIT(control,16) || GET_BIT(STK->CTRL,16))
+        return STK->LOAD + elapsed;
+
+    return elapsed;
+}
+
+
+// Restart the periodic interrupts of periodCounts timer counts, the first one after firstCounts.
+void STK_resumeIntervalPeriodic ( uint32 periodCounts, uint32 firstCounts )
+{
+    CLR_BIT(STK->CTRL,0);
+
+    // The counter starts from the first interval.
+    STK->LOAD = firstCounts;
+    STK->VAL  = 0;
+
+    // Enable Interrupt and SYSTick.
+    SET_BIT(STK->CTRL,1);
+    SET_BIT(STK->CTRL,0);
+
+    // Once the counter took the first interval, the period is loaded for the next reloads.
+    while (STK->VAL == 0)
+        ;
+
+    STK->LOAD = periodCounts;
+}
+
+
+// Get the longest interval in microseconds the SysTick timer can be loaded with.
+uint32 STK_getMaxInterval(void)
+{
+    // LOAD is a 24-bit register.
+    return STK_countsToMicroSec(STK_MAX_LOAD);
+}
+
+
 // Stop the SysTick timer from generating interrupts.
 void STK_stopInterval (void)
 {
@@ -70,36 +159,72 @@ void STK_stopInterval (void)
 
 }
 
+// Account for the timer reloads the kernel counted, the counter restarts from LOAD by itself.
+void STK_countReloads(uint32 reloads)
+{
+    (void)reloads;
+
+    // The counter restarted already, reading CTRL clears the COUNTFLAG of the reload counted now.
+    (void)STK->CTRL;
+    reloadSeen = FALSE;
+}
+
 // Get the amount of time that has elapsed since the last SysTick interrupt in microseconds.
 uint32 STK_getElapsedTime(void)
 {
-    // Initialize ElapsedTime to 0.
-    float32 ElapsedTime = 0;
+    // Convert the number of ticks that have elapsed to microseconds.
+    return STK_countsToMicroSec(STK->LOAD - STK->VAL);
+}
+
+// Get the remaining time until the next SysTick interrupt in microseconds.
+uint32 STK_getRemainingTime(void)
+{
+    // Convert the number of ticks remaining until the next interrupt to microseconds.
+    return STK_countsToMicroSec(STK->VAL);
+}
 
-    // Calculate the number of ticks that have elapsed.
-    ElapsedTime = (STK->LOAD - STK->VAL);
+// Get the raw timer counts elapsed since the last SysTick interrupt.
+uint32 STK_getElapsedCounts(void)
+{
+    uint32 value = STK->VAL;
 
-    // Convert ticks to microseconds using the microSecToTicksRatio constant.
-    ElapsedTime /= microSecToTicksRatio;
+    // VAL stays 0 for a count after the reload, the interval already ended and is counted as pending.
+    return (value != 0) ? (STK->LOAD - value) : 0;
+}
 
-    // Return the elapsed time in microseconds.
-    return (uint32)ElapsedTime;
+// Get the number of timer counts of the loaded interval.
+uint32 STK_getIntervalCounts(void)
+{
+    return STK->LOAD;
 }
 
-// Get the remaining time until the next SysTick interrupt in microseconds.
-uint32 STK_getRemainingTime(void)
+// Check whether the timer reloaded and its interrupt has not run yet.
+uint8 STK_isReloadPending(void)
 {
-    // Initialize RemainingTime to 0.
-    float32 RemainingTime = 0;
+    uint32 state;
+    uint8 pending;
+
+    // Reading COUNTFLAG clears it, no other reader of the time may run before it is kept in reloadSeen.
+    state = DISABLE_INTERRUPTS_FROM_ISR();
+
+    if (GET_BIT(STK->CTRL,16))
+        reloadSeen = TRUE;
 
-    // Calculate the number of ticks remaining until the next interrupt.
-    RemainingTime = STK->VAL;
+    pending = reloadSeen || GET_BIT(STK_ICSR,26);
 
-    // Convert ticks to microseconds using the microSecToTicksRatio constant.
-    RemainingTime /= microSecToTicksRatio;
+    RESTORE_INTERRUPTS_FROM_ISR(state);
 
-    // Return the remaining time in microseconds.
-    return (uint32)RemainingTime;
+    return pending;
 }
 
+// Convert timer counts to nanoseconds.
+uint64 STK_countsToNs(uint32 counts)
+{
+    return ((uint64)counts * NS_PER_COUNT_SCALED) >> STK_SCALE_SHIFT;
+}
 
+// Convert timer counts to microseconds.
+uint32 STK_countsToMicroSec(uint32 counts)
+{
+    return (uint32)(((uint64)counts * US_PER_COUNT_SCALED) >> STK_SCALE_SHIFT);
+}
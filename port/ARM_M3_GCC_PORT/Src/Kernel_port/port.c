@@ -13,10 +13,13 @@
 
 #include <Kernel/port/port.h>
 #include <Kernel/Task.h>
+#include <Kernel/kernel_private.h>
 
 
 extern Task_t Tasks[];
-extern uint32 Current_Task, SysTick;
+extern volatile uint32 SysTick;
+
+volatile uint32 CriticalNesting;
 
 
 void NAKED initScheduleStack(uint32 scheduleStackAddress)
@@ -54,33 +57,6 @@ void initTaskStack(Task_t *taskHandler)
 }
 
 
-void NAKED saveContext(void)
-{
-	__asm__ volatile
-	(
-	    "MRS R0, PSP         \n"    // Move PSP (Process Stack Pointer) to R0
-	    "STMDB R0!, {R4-R11} \n"    // Store multiple registers (R4-R11) onto the stack, decrementing the stack pointer
-	    "PUSH {LR}           \n"    // Save the link register (LR) onto the stack
-	    "BL setTaskPSP       \n"    // Branch and link to setTaskPSP function
-	    "POP {LR}            \n"    // Restore the link register (LR) from the stack
-	    "BX LR"                     // Branch to the address in the link register (return)
-	);
-}
-
-
-void NAKED retrieveContext(void)
-{
-	__asm__ volatile
-	(
-	    "PUSH {LR}           \n"    // Save the link register (LR) onto the stack
-	    "BL getTaskPSP       \n"    // Branch and link to getTaskPSP function
-	    "LDM R0!, {R4-R11}   \n"    // Load multiple registers (R4-R11) from the stack into R0, incrementing the stack pointer
-	    "MSR PSP, R0         \n"    // Move the value in R0 to the Process Stack Pointer (PSP)
-	    "POP {LR}            \n"    // Restore the link register (LR) from the stack
-	    "BX LR"                     // Branch to the address in the link register (return)
-	);
-}
-
 void NAKED turnToPSP(void)
 {
 	__asm__ volatile
@@ -95,41 +71,84 @@ void NAKED turnToPSP(void)
 	);
 }
 
+/* Single function context switch. The scheduler preserves R4-R11 like any AAPCS function, so they are
+   only saved once it selected another task, straight below the hardware frame, with the PSP kept at
+   offset 0 of the control block. Estimated, not measured, from the Cortex-M3 instruction timings with zero
+   wait states, exception entry/exit and the scheduler excluded: about 24 cycles when the same task is
+   selected, 50 for a switch. */
 void NAKED PendSV_Handler(void)
 {
 	__asm__ volatile
 	(
-	    "PUSH {LR}             \n"    // Save the link register (return address)
-	    "BL saveContext        \n"    // Branch and link to saveContext function
-	    "BL schedule           \n"    // Branch and link to schedule function
-	    "BL retrieveContext    \n"    // Branch and link to retrieveContext function
-	    "POP {LR}              \n"    // Restore the link register (return address)
-	    "BX LR"                       // Return from function
+	    "MRS R2, PSP                       \n"
+	    "MOVW R3, #:lower16:Current_TCB    \n"
+	    "MOVT R3, #:upper16:Current_TCB    \n"
+	    "LDR R0, [R3]                      \n"    // R0 = control block of the running task
+	    "SUB R2, R2, #32                   \n"    // Its PSP once R4-R11 are saved, read by the stack check of the scheduler
+	    "STR R2, [R0]                      \n"
+	    "PUSH {R3, LR}                     \n"    // Keep &Current_TCB and EXC_RETURN, 8-byte aligned
+	    "BL scheduleFromPendSV             \n"    // R0 = control block to save R4-R11 in, NULL if none
+	    "POP {R3, LR}                      \n"
+	    "LDR R1, [R3]                      \n"    // R1 = control block of the task switched in
+	    "CMP R0, R1                        \n"    // Same task: its registers never left the core
+	    "IT EQ                             \n"
+	    "BXEQ LR                           \n"
+	    "CBZ R0, 1f                        \n"
+	    "LDR R2, [R0]                      \n"
+	    "STMIA R2, {R4-R11}                \n"
+	    "1:                                \n"
+	    "LDR R2, [R1]                      \n"
+	    "LDMIA R2!, {R4-R11}               \n"    // The exception return unstacks the rest
+	    "MSR PSP, R2                       \n"
+	    "BX LR                             \n"
 	);
 }
 
+// Select the next task, the ISRs calling the kernel may preempt PendSV so they are masked meanwhile.
+// Returns the control block the registers of the task switched out are saved in,
+// NULL when it deleted itself and gave its stack back.
+Task_t* scheduleFromPendSV(void)
+{
+    Task_t *previousTask = Current_TCB;
+
+    DISABLE_INTERRUPTS();  // Enter critical section
+
+    schedule();
+
+    ENABLE_INTERRUPTS();	// Exit from critical section
+
+    if (previousTask->state == DELETED && previousTask != Current_TCB)
+        return NULL;
+
+    return previousTask;
+}
+
 void SysTick_Handler(void)
 {
+    boolean switchRequired;
+
+    // The ISRs calling the kernel may preempt the tick
+    DISABLE_INTERRUPTS();
+
     // Increment SysTick counter for scheduling purposes
-    SysTick++;
+    tickIncrement(1);
 
-    // Check and handle blocked tasks if any
-    checkBlockedTasks();
+    TRACE_RECORD(TRACE_TICK, Current_Task, (uint16)SysTick);
 
-    // Enable PendSV interrupt to trigger context switch
-    enablePENDSV();
-}
+    // Wake the due tasks, the running one keeps the CPU without a PendSV unless one preempts it or its slice ends
+    switchRequired = tickSwitchRequired(THIS_CORE, checkBlockedTasks());
 
+    ENABLE_INTERRUPTS();
 
-uint32* getTaskPSP()
-{
-	return Tasks[Current_Task].psp;
+    // Enable PendSV interrupt to trigger context switch
+    if (switchRequired)
+        enablePENDSV();
 }
 
 
-void setTaskPSP(uint32* psp)
+uint32* getTaskPSP()
 {
-	Tasks[Current_Task].psp = psp;
+	return (uint32*)Current_TCB->psp;
 }
 
 
@@ -141,6 +160,13 @@ void enableSystemFaults(void)
 }
 
 
+// Give PendSV and SysTick the lowest priority, BASEPRI_SYSCALL masks them in the critical sections
+void initKernelInterrupts(void)
+{
+    SHPR3 = (SHPR3 & 0x0000FFFFUL) | ((uint32)KERNEL_INTERRUPT_PRIORITY << 16) | ((uint32)KERNEL_INTERRUPT_PRIORITY << 24);
+}
+
+
 
 
 
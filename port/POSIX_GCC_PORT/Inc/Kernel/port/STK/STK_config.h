@@ -0,0 +1,23 @@
+/*********************************************************************************/
+/* Author      : Ibrahim Diab                                                    */
+/* File Name   : STK_config.h                                                    */
+/* Compiler	   : GCC , C99															  */
+/* Target	   : Linux host (POSIX)											      */
+/* Description : Configuration for the interval timer standing in for SysTick    */
+/*********************************************************************************/
+
+
+#ifndef STK_CONFIG_H
+#define STK_CONFIG_H
+
+
+
+/*
+[Must]
+Options: 
+         STK_WALL_CLOCK // ITIMER_REAL, ticks follow wall-clock time (SIGALRM)
+         STK_CPU_CLOCK  // ITIMER_VIRTUAL, ticks follow process CPU time (SIGVTALRM)
+*/
+#define STK_CLOCK_SOURCE  STK_WALL_CLOCK
+
+#endif // STK_CONFIG_H
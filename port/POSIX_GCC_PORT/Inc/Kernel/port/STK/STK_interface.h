@@ -0,0 +1,66 @@
+/**************************************************************************************/
+/* Author      : Ibrahim Diab                                                         */
+/* File Name   : STK_interface.h                                                      */
+/* Compiler	   : GCC , C99															  */
+/* Target	   : Linux host (POSIX)											      */
+/* Description : Interfacing macros for the interval timer standing in for SysTick    */
+/**************************************************************************************/
+
+
+#ifndef STK_INTERFACE_H
+#define STK_INTERFACE_H
+
+
+// Initialize the SysTick timer.
+void STK_init(void);
+
+// Set the SysTick timer to trigger periodic interrupts after a specified number of microseconds.
+void STK_setIntervalPeriodic ( uint32 NoMicroSec );
+
+// Restart the SysTick timer so it interrupts once after a specified number of timer counts,
+// a reload not handled yet is dropped: the caller counts it (used by the tickless idle mode).
+void STK_setIntervalSingleCounts ( uint32 counts );
+
+// Stop the interval loaded by STK_setIntervalSingleCounts and get the counts elapsed since it was loaded,
+// at least the loaded counts exactly when it expired and its interrupt is pending.
+uint32 STK_stopIntervalSingle(void);
+
+// Restart the periodic interrupts of periodCounts timer counts, the first one after firstCounts,
+// so the tick interrupted by STK_setIntervalSingleCounts keeps its length.
+void STK_resumeIntervalPeriodic ( uint32 periodCounts, uint32 firstCounts );
+
+// Account for timer reloads the kernel counted as ticks, called inside its update of the tick count.
+void STK_countReloads(uint32 reloads);
+
+// Get the number of timer reloads not counted by the kernel yet, at least one in the timer signal handler.
+// The host drops the signal of a reload that comes while the previous one is pending.
+uint32 STK_getReloadsPending(void);
+
+// Get the longest interval in microseconds the SysTick timer can be loaded with.
+uint32 STK_getMaxInterval(void);
+
+// Stop the SysTick timer from generating interrupts.
+void STK_stopInterval(void);
+
+// Get the amount of time in microseconds that has elapsed since the last SysTick interrupt in ticks.
+uint32 STK_getElapsedTime(void);
+
+// Get the remaining time in microseconds until the next SysTick interrupt in ticks.
+uint32 STK_getRemainingTime(void);
+
+// Get the raw timer counts elapsed since the last SysTick interrupt, cheaper than STK_getElapsedTime.
+uint32 STK_getElapsedCounts(void);
+
+// Get the number of timer counts of the loaded interval.
+uint32 STK_getIntervalCounts(void);
+
+// Check whether the timer reloaded and its signal has not been handled yet, the elapsed counts restarted from 0.
+uint8 STK_isReloadPending(void);
+
+// Convert timer counts to nanoseconds and microseconds.
+uint64 STK_countsToNs(uint32 counts);
+uint32 STK_countsToMicroSec(uint32 counts);
+
+
+
+#endif // STK_INTERFACE_H
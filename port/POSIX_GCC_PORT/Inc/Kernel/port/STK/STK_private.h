@@ -0,0 +1,31 @@
+/*************************************************************************************/
+/* Author      : Ibrahim Diab                                                        */
+/* File Name   : STK_private.h                                                       */
+/* Compiler	   : GCC , C99															  */
+/* Target	   : Linux host (POSIX)											      */
+/* Description : Private definitions for the interval timer standing in for SysTick  */
+/*************************************************************************************/
+
+
+#ifndef STK_PRIVATE_H
+#define STK_PRIVATE_H
+
+#include <signal.h>
+#include <sys/time.h>
+#include <time.h>
+
+#define STK_WALL_CLOCK        0
+#define STK_CPU_CLOCK         1
+
+#if STK_CLOCK_SOURCE == STK_WALL_CLOCK
+#define STK_TIMER             ITIMER_REAL
+#define STK_SIGNAL            SIGALRM
+#define STK_CLOCK             CLOCK_MONOTONIC
+#else
+#define STK_TIMER             ITIMER_VIRTUAL
+#define STK_SIGNAL            SIGVTALRM
+#define STK_CLOCK             CLOCK_PROCESS_CPUTIME_ID
+#endif
+
+
+#endif // STK_PRIVATE_H
@@ -0,0 +1,147 @@
+/**
+ ********************************************************************************************
+ * File           : port.h
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Linux host (POSIX)
+ * Brief          : Main header for kernel port APIs related to the Linux host target.
+ ********************************************************************************************
+ */
+
+#ifndef _PORT_H_
+#define _PORT_H_
+
+#include <stdint.h>
+
+#include "../../LIB/std_types.h"
+
+#include "../kernel_interface.h"
+#include "../Task.h"
+
+
+// Size of the host stack given to every task, the kernel stack size is only bookkeeping on this port
+#ifndef POSIX_TASK_STACK_SIZE
+#define POSIX_TASK_STACK_SIZE	 (64 * 1024)
+#endif
+
+
+// Simulated SRAM the kernel carves its task stacks from.
+// SRAM_END is kept a plain identifier so it can still be used in #if expressions.
+extern const uintptr_t POSIX_SramEnd;
+
+#ifndef SRAM_END
+#define SRAM_END				 POSIX_SramEnd
+#endif
+
+
+#if NUM_CORES > 1
+// Cores are host threads, the kernel state is shared under one recursive spinlock taken with the mask
+#define DISABLE_INTERRUPTS() 	 do{ disableInterrupts(); kernelLock();  } while(0)
+#define ENABLE_INTERRUPTS()  	 do{ kernelUnlock(); enableInterrupts(); } while(0)
+#else
+#define DISABLE_INTERRUPTS() 	 do{ disableInterrupts(); } while(0)
+#define ENABLE_INTERRUPTS()  	 do{ enableInterrupts();  } while(0)
+#endif
+
+// Mask interrupts from an ISR, returns the previous mask to restore (nests with DISABLE_INTERRUPTS)
+#define DISABLE_INTERRUPTS_FROM_ISR()        disableInterruptsFromISR()
+#define RESTORE_INTERRUPTS_FROM_ISR(state)   restoreInterruptsFromISR(state)
+
+// Sleep until an interrupt is pending, wakes up even while interrupts are disabled
+#define WAIT_FOR_INTERRUPT()	 do{ waitForInterrupt(); } while(0)
+
+// Number of leading zero bits of a non zero word
+#define COUNT_LEADING_ZEROS(x)	 ((uint32)__builtin_clz(x))
+
+// Add one to a uint32 without masking interrupts, returns the value before, a locked add
+#define ATOMIC_FETCH_INCREMENT(variable)   __atomic_fetch_add((variable), 1, __ATOMIC_RELAXED)
+
+// Write desired to a uint32 if it still holds expected without masking interrupts, returns whether it did, a locked compare and exchange
+#define ATOMIC_COMPARE_EXCHANGE(variable, expected, desired)   __sync_bool_compare_and_swap((variable), (expected), (desired))
+
+// Order the memory accesses before it against the ones after it, for the CPU and the compiler, a full fence
+#define MEMORY_BARRIER()                   __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+// Memory a task runs on and the stack pointer saved when it was switched out,
+// tasks run on their host stack rather than on the stack the kernel accounts for
+#define GET_STACK_BOTTOM(task)               getHostStackBottom(task)
+#define GET_STACK_SIZE(task)                 ((uint32)POSIX_TASK_STACK_SIZE)
+#define GET_SAVED_STACK_POINTER(task)        getHostStackPointer(task)
+
+#define enablePENDSV()		     triggerPendSV()
+
+// Timer counts elapsed in the current tick for timestamps, a clock read on this port
+#define GET_TICK_ELAPSED_COUNTS()	 STK_getElapsedCounts()
+
+#if NUM_CORES > 1
+// Core of the calling thread and the task it runs
+#define GET_CORE_ID()			 getCoreId()
+#define GET_CURRENT_TASK()		 getCurrentTask()
+
+// Pend the PendSV signal of another core, an inter-processor interrupt
+#define enableCorePENDSV(core)	 triggerCorePendSV(core)
+#endif
+
+
+
+void initTaskStack( Task_t *taskHandler);
+
+void initScheduleStack(uint32 scheduleStackAddress);
+
+void turnToPSP(void);
+
+void enableSystemFaults(void);
+
+void initKernelInterrupts(void);
+
+// Block the SysTick and PendSV signals (equivalent of "cpsid i").
+void disableInterrupts(void);
+
+// Unblock the SysTick and PendSV signals (equivalent of "cpsie i").
+void enableInterrupts(void);
+
+// Block the interrupt signals, returns whether they were blocked already.
+uint32 disableInterruptsFromISR(void);
+
+// Unblock the interrupt signals unless they were blocked before disableInterruptsFromISR().
+void restoreInterruptsFromISR(uint32 state);
+
+// Wait for a blocked interrupt signal and leave it pending (equivalent of "wfi").
+void waitForInterrupt(void);
+
+// Route a signal to an application ISR, it is masked by DISABLE_INTERRUPTS() like the kernel signals
+// so the ISR may call the FromISR kernel APIs. Call before os_start().
+void installInterruptHandler(int signalNumber, void (*isr)(void));
+
+// Lowest address of the host stack of a task.
+uint32* getHostStackBottom(const Task_t *taskHandler);
+
+// Host stack pointer of a task when it was switched out.
+uint32* getHostStackPointer(const Task_t *taskHandler);
+
+// Pend the PendSV signal, it is taken as soon as it is unblocked.
+void triggerPendSV(void);
+
+#if NUM_CORES > 1
+// Core the calling thread runs, 0 for the thread calling os_start().
+uint32 getCoreId(void);
+
+// ID of the task running on the calling core.
+uint32 getCurrentTask(void);
+
+// Take the kernel lock of the calling core, it nests. Called with the interrupt signals blocked.
+void kernelLock(void);
+
+void kernelUnlock(void);
+
+// Pend the PendSV signal of a core, ignored until the core started.
+void triggerCorePendSV(uint32 core);
+#endif
+
+void SysTick_Handler(void);
+
+void PendSV_Handler(void);
+
+
+
+#endif // _PORT_H_
@@ -0,0 +1,223 @@
+/********************************************************************************************/
+/* Author      : Ibrahim Diab                                                               */
+/* File Name   : STK.c                                                                      */
+/* Description : Functions Implementation for the interval timer standing in for SysTick    */
+/*               on a Linux host, the timer signal is routed to SysTick_Handler by port.c   */
+/********************************************************************************************/
+
+#include <../Inc/LIB/common_macros.h>
+#include <../Inc/LIB/std_types.h>
+
+#include <Kernel/port/STK/STK_config.h>
+#include <Kernel/port/STK/STK_interface.h>
+#include <Kernel/port/STK/STK_private.h>
+
+
+// Interval currently loaded in the timer, the equivalent of STK->LOAD in microseconds.
+static volatile uint32 loadedMicroSec = 0;
+
+// Start of the tick the kernel counted last, on the clock of the timer. The counts are read from the clock:
+// the host stops the timer while its signal is pending, where a SysTick counter keeps counting.
+static volatile uint64 tickStartNs = 0;
+
+// Single interval in microseconds and the times it was loaded and stopped at.
+static uint32 singleMicroSec;
+static uint64 singleStartNs, singleStopNs;
+
+
+// Read the clock the timer counts on in nanoseconds.
+static uint64 readClockNs(void)
+{
+    struct timespec time;
+
+    (void)clock_gettime(STK_CLOCK, &time);
+
+    return (uint64)time.tv_sec * 1000000000ULL + (uint64)time.tv_nsec;
+}
+
+
+// Load the timer with a first interval and a reload interval in nanoseconds, 0 stops it.
+static void loadTimer(uint64 firstNs, uint64 intervalNs)
+{
+    struct itimerval timer;
+
+    timer.it_value.tv_sec     = (time_t)(firstNs / 1000000000ULL);
+    timer.it_value.tv_usec    = (suseconds_t)((firstNs % 1000000000ULL) / 1000);
+    timer.it_interval.tv_sec  = (time_t)(intervalNs / 1000000000ULL);
+    timer.it_interval.tv_usec = (suseconds_t)((intervalNs % 1000000000ULL) / 1000);
+
+    (void)setitimer(STK_TIMER, &timer, NULL);
+}
+
+
+// Read the microseconds elapsed since the start of the tick the kernel counted last.
+static uint32 readTickMicroSec(void)
+{
+    int64 elapsed = (int64)(readClockNs() - tickStartNs);
+
+    // The timer signal may come a little earlier than the clock says
+    return (elapsed > 0) ? (uint32)(elapsed / 1000) : 0;
+}
+
+
+// Initialize the SysTick timer.
+void STK_init ()
+{
+    // Make sure no interval is running before the kernel programs one.
+    STK_stopInterval();
+}
+
+
+// Set the SysTick timer to trigger periodic interrupts after a specified number of microseconds.
+void STK_setIntervalPeriodic ( uint32 NoMicroSec )
+{
+    loadedMicroSec = NoMicroSec;
+    tickStartNs    = readClockNs();
+
+    // Loaded after the clock is read, the signal never comes before the clock reaches the end of the tick
+    loadTimer((uint64)NoMicroSec * 1000, (uint64)NoMicroSec * 1000);
+}
+
+
+// Restart the SysTick timer so it interrupts once after a specified number of timer counts.
+void STK_setIntervalSingleCounts ( uint32 counts )
+{
+    sigset_t pending;
+
+    singleMicroSec = (counts != 0) ? counts : 1;
+    singleStartNs  = readClockNs();
+
+    loadTimer((uint64)singleMicroSec * 1000, 0);
+
+    // A reload since the caller read the elapsed counts is part of the new interval, its signal is dropped.
+    (void)sigpending(&pending);
+
+    if (sigismember(&pending, STK_SIGNAL) == 1)
+    {
+        sigset_t timerSignal;
+        int signalNumber;
+
+        sigemptyset(&timerSignal);
+        sigaddset(&timerSignal, STK_SIGNAL);
+
+        (void)sigwait(&timerSignal, &signalNumber);
+    }
+}
+
+
+// Stop the interval loaded by STK_setIntervalSingleCounts and get the counts elapsed since it was loaded.
+uint32 STK_stopIntervalSingle(void)
+{
+    struct itimerval timer = {0}, previous;
+    uint32 elapsed;
+
+    (void)setitimer(STK_TIMER, &timer, &previous);
+    singleStopNs = readClockNs();
+
+    elapsed = (uint32)((singleStopNs - singleStartNs) / 1000);
+
+    // A disarmed timer expired and its signal is pending, an armed one has counts left.
+    if (previous.it_value.tv_sec == 0 && previous.it_value.tv_usec == 0)
+        return (elapsed > singleMicroSec) ? elapsed : singleMicroSec;
+
+    return (elapsed < singleMicroSec) ? elapsed : (singleMicroSec - 1);
+}
+
+
+// Restart the periodic interrupts of periodCounts timer counts, the first one after firstCounts.
+void STK_resumeIntervalPeriodic ( uint32 periodCounts, uint32 firstCounts )
+{
+    // The first interval is counted from the time the single interval stopped at
+    int64 firstNs = (int64)((uint64)firstCounts * 1000 + singleStopNs - readClockNs());
+
+    loadedMicroSec = periodCounts;
+
+    loadTimer((firstNs >= 1000) ? (uint64)firstNs : 1000, (uint64)periodCounts * 1000);
+}
+
+
+// Get the longest interval in microseconds the SysTick timer can be loaded with.
+uint32 STK_getMaxInterval(void)
+{
+    // Twice the interval still fits the counts of STK_stopIntervalSingle.
+    return 0x7FFFFFFF;
+}
+
+
+// Stop the SysTick timer from generating interrupts.
+void STK_stopInterval (void)
+{
+    loadedMicroSec = 0;
+
+    loadTimer(0, 0);
+}
+
+
+// Account for the timer reloads the kernel counted, the next tick starts an interval later.
+void STK_countReloads(uint32 reloads)
+{
+    tickStartNs += (uint64)reloads * loadedMicroSec * 1000;
+}
+
+// Get the number of timer reloads not counted by the kernel yet, at least one in the timer signal handler.
+uint32 STK_getReloadsPending(void)
+{
+    uint32 reloads = (loadedMicroSec != 0) ? (readTickMicroSec() / loadedMicroSec) : 0;
+
+    return (reloads != 0) ? reloads : 1;
+}
+
+// Get the amount of time that has elapsed since the last SysTick interrupt in microseconds.
+uint32 STK_getElapsedTime(void)
+{
+    return STK_getElapsedCounts();
+}
+
+// Get the remaining time until the next SysTick interrupt in microseconds.
+uint32 STK_getRemainingTime(void)
+{
+    uint32 elapsed = readTickMicroSec();
+
+    return (elapsed < loadedMicroSec) ? (loadedMicroSec - elapsed) : 0;
+}
+
+
+// Get the raw timer counts elapsed since the last SysTick interrupt, the counts are microseconds on this port.
+uint32 STK_getElapsedCounts(void)
+{
+    uint32 elapsed = readTickMicroSec();
+
+    if (loadedMicroSec == 0)
+        return 0;
+
+    // The timer reloaded and the kernel did not count it yet, the counts restarted like those of a SysTick counter
+    return (elapsed >= loadedMicroSec) ? (elapsed - loadedMicroSec) : elapsed;
+}
+
+
+// Get the number of timer counts of the loaded interval.
+uint32 STK_getIntervalCounts(void)
+{
+    return loadedMicroSec;
+}
+
+
+// Check whether the timer reloaded and its signal has not been handled yet.
+uint8 STK_isReloadPending(void)
+{
+    return (loadedMicroSec != 0 && readTickMicroSec() >= loadedMicroSec);
+}
+
+
+// Convert timer counts to nanoseconds, the counts are microseconds on this port.
+uint64 STK_countsToNs(uint32 counts)
+{
+    return (uint64)counts * 1000;
+}
+
+
+// Convert timer counts to microseconds.
+uint32 STK_countsToMicroSec(uint32 counts)
+{
+    return counts;
+}
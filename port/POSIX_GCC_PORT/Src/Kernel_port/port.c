@@ -0,0 +1,467 @@
+/**
+ ************************************************************************
+ * File           : port.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Linux host (POSIX)
+ * Brief          : Functions specific to the Linux host in the kernel.
+ *                  Task contexts are ucontexts, the STK timer signal
+ *                  stands in for SysTick and SIGUSR1 for PendSV.
+ *                  With NUM_CORES > 1 every core is a host thread.
+ ************************************************************************
+ */
+
+#include <signal.h>
+#include <unistd.h>
+#include <ucontext.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <../Inc/LIB/std_types.h>
+#include <../Inc/LIB/common_macros.h>
+
+#include <Kernel/port/port.h>
+#include <Kernel/port/STK/STK_config.h>
+#include <Kernel/port/STK/STK_interface.h>
+#include <Kernel/port/STK/STK_private.h>
+#include <Kernel/Task.h>
+#include <Kernel/kernel_private.h>
+
+
+#define PENDSV_SIGNAL			 SIGUSR1
+
+
+extern Task_t Tasks[];
+extern volatile uint32 SysTick;
+
+
+// Simulated SRAM, only used by the kernel to account for task stacks
+static uint8 Sram[APP_STACK_SIZE];
+const uintptr_t POSIX_SramEnd = (uintptr_t)&Sram[APP_STACK_SIZE];
+
+// Saved context and host stack of every task control block
+static ucontext_t TaskContext[TASK_TABLE_SIZE];
+static uint8 TaskStack[TASK_TABLE_SIZE][POSIX_TASK_STACK_SIZE] __attribute__((aligned(16)));
+
+// Host stack pointer of every task when it was switched out
+static uint32 *TaskStackPointer[TASK_TABLE_SIZE];
+
+// Signals masked by DISABLE_INTERRUPTS()
+static sigset_t InterruptSignals;
+
+// Set once the first task is running, PendSV is ignored before that
+static volatile sig_atomic_t Scheduler_Started = FALSE;
+
+// Stack the fault handler of every core runs on, set by enableSystemFaults()
+static uint8 FaultStack[NUM_CORES][16 * 1024];
+static volatile sig_atomic_t Faults_Enabled = FALSE;
+
+
+#if NUM_CORES > 1
+
+#define NO_CORE					 0xFFFFFFFFUL
+
+// Host thread of every core, valid once the core started
+static pthread_t CoreThread[NUM_CORES];
+static volatile sig_atomic_t Core_Started[NUM_CORES];
+
+// Core of the calling host thread
+static __thread uint32 CoreId;
+
+// Core holding the kernel lock and how many times it took it
+static volatile uint32 KernelLockOwner = NO_CORE;
+static uint32 KernelLockNesting;
+
+
+uint32 getCoreId(void)
+{
+    return CoreId;
+}
+
+
+uint32 getCurrentTask(void)
+{
+    sigset_t previous;
+    uint32 taskId;
+
+    // Not switched out, possibly to another core, between the two reads
+    (void)pthread_sigmask(SIG_BLOCK, &InterruptSignals, &previous);
+    taskId = CurrentTasks[CoreId];
+    (void)pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+    return taskId;
+}
+
+
+void kernelLock(void)
+{
+    uint32 core = CoreId;
+
+    if (KernelLockOwner == core)
+    {
+        KernelLockNesting++;
+        return;
+    }
+
+    // The holder may be preempted by the host, give it the CPU
+    while (!ATOMIC_COMPARE_EXCHANGE(&KernelLockOwner, NO_CORE, core))
+        (void)sched_yield();
+
+    KernelLockNesting = 1;
+}
+
+
+void kernelUnlock(void)
+{
+    if (--KernelLockNesting == 0)
+        __atomic_store_n(&KernelLockOwner, NO_CORE, __ATOMIC_RELEASE);
+}
+
+
+void triggerCorePendSV(uint32 core)
+{
+    if (core == CoreId)
+        triggerPendSV();
+    else if (Core_Started[core])
+        (void)pthread_kill(CoreThread[core], PENDSV_SIGNAL);
+}
+
+#endif
+
+
+static void SysTick_SignalHandler(int signalNumber)
+{
+    (void)signalNumber;
+    SysTick_Handler();
+}
+
+static void PendSV_SignalHandler(int signalNumber)
+{
+    (void)signalNumber;
+    PendSV_Handler();
+}
+
+static void Fault_SignalHandler(int signalNumber)
+{
+    static const char message[] = "kernel: fault in task ";
+
+    // Report the faulting task with async-signal-safe calls only
+    (void)write(STDERR_FILENO, message, sizeof(message) - 1);
+    for (uint8 i = 0; i < TASK_NAME_LEN && Tasks[Current_Task].name[i]; i++)
+        (void)write(STDERR_FILENO, (const char*)&Tasks[Current_Task].name[i], 1);
+    (void)write(STDERR_FILENO, "\n", 1);
+
+    // Let the default action terminate the process
+    (void)signal(signalNumber, SIG_DFL);
+    (void)raise(signalNumber);
+}
+
+
+// Application interrupts, indexed by signal number
+static void (*InterruptHandler[NSIG])(void);
+
+static void Interrupt_SignalHandler(int signalNumber)
+{
+    os_traceIsrEnter(signalNumber);
+    InterruptHandler[signalNumber]();
+    os_traceIsrExit(signalNumber);
+}
+
+
+// Install a handler masking every interrupt signal, like an exception of the same priority.
+static void installHandler(int signalNumber, void (*handler)(int))
+{
+    struct sigaction action = {0};
+
+    action.sa_mask    = InterruptSignals;
+    action.sa_flags   = SA_RESTART;
+    action.sa_handler = handler;
+
+    (void)sigaction(signalNumber, &action, NULL);
+}
+
+
+// Install the signal handlers that play the role of the vector table.
+static void __attribute__((constructor)) initVectorTable(void)
+{
+    sigemptyset(&InterruptSignals);
+    sigaddset(&InterruptSignals, STK_SIGNAL);
+    sigaddset(&InterruptSignals, PENDSV_SIGNAL);
+
+    // Both handlers mask each other, so a PendSV raised by the tick is tail-chained after it
+    installHandler(STK_SIGNAL, &SysTick_SignalHandler);
+    installHandler(PENDSV_SIGNAL, &PendSV_SignalHandler);
+}
+
+
+void installInterruptHandler(int signalNumber, void (*isr)(void))
+{
+    sigaddset(&InterruptSignals, signalNumber);
+    InterruptHandler[signalNumber] = isr;
+
+    // Reinstall every handler so they all mask the new interrupt signal too
+    installHandler(STK_SIGNAL, &SysTick_SignalHandler);
+    installHandler(PENDSV_SIGNAL, &PendSV_SignalHandler);
+
+    for (int i = 1; i < NSIG; i++)
+        if (InterruptHandler[i] != NULL)
+            installHandler(i, &Interrupt_SignalHandler);
+}
+
+
+void initScheduleStack(uint32 scheduleStackAddress)
+{
+    // Signal handlers run on the interrupted task stack, there is no main stack to move
+    (void)scheduleStackAddress;
+}
+
+
+// First code of every task, the interrupt signals are unmasked only once its stack is in use.
+// With NUM_CORES > 1 it also releases the kernel lock held by the core switching to it.
+static void taskEntry(void)
+{
+    osFunc_t taskFunction = Tasks[Current_Task].task_func;
+
+    ENABLE_INTERRUPTS();
+
+    taskFunction();
+}
+
+
+// Function to initialize the context for a new task
+void initTaskStack(Task_t *taskHandler)
+{
+    ucontext_t *context = &TaskContext[taskHandler->id];
+
+    (void)getcontext(context);
+
+    // Run the task function on its own host stack
+    context->uc_stack.ss_sp   = TaskStack[taskHandler->id];
+    context->uc_stack.ss_size = POSIX_TASK_STACK_SIZE;
+    context->uc_link          = NULL;
+
+    // swapcontext() sets the mask of the next context before it leaves the current stack,
+    // a tick let in there would save the half switched context as the one of the new task
+    context->uc_sigmask = InterruptSignals;
+
+    makecontext(context, &taskEntry, 0);
+
+    // The PSP slot holds the saved context on this port
+    taskHandler->psp = (uint32*)context;
+
+    TaskStackPointer[taskHandler->id] = (uint32*)&TaskStack[taskHandler->id][POSIX_TASK_STACK_SIZE];
+}
+
+
+uint32* getHostStackBottom(const Task_t *taskHandler)
+{
+    return (uint32*)TaskStack[taskHandler->id];
+}
+
+
+uint32* getHostStackPointer(const Task_t *taskHandler)
+{
+    return TaskStackPointer[taskHandler->id];
+}
+
+
+// Give the fault handler of the calling core its own stack
+static void installFaultStack(void)
+{
+    stack_t altStack = {0};
+
+    altStack.ss_sp   = FaultStack[THIS_CORE];
+    altStack.ss_size = sizeof(FaultStack[THIS_CORE]);
+    (void)sigaltstack(&altStack, NULL);
+}
+
+
+#if NUM_CORES > 1
+
+// Host thread of the cores after the first one, it starts with the interrupt signals blocked
+static void* coreThread(void *argument)
+{
+    CoreId = (uint32)(uintptr_t)argument;
+
+    if (Faults_Enabled)
+        installFaultStack();
+
+    // Waits here until the first core runs its first task
+    kernelLock();
+
+    CoreThread[CoreId] = pthread_self();
+    Core_Started[CoreId] = TRUE;
+
+    // Pick a task from the start, the idle task of the core until another one is ready
+    schedule();
+
+    (void)setcontext((ucontext_t*)Tasks[Current_Task].psp);
+
+    return NULL;
+}
+
+#endif
+
+
+void turnToPSP(void)
+{
+    DISABLE_INTERRUPTS();
+
+    Scheduler_Started = TRUE;
+
+#if NUM_CORES > 1
+    CoreThread[0] = pthread_self();
+    Core_Started[0] = TRUE;
+
+    for (uint32 core = 1; core < NUM_CORES; core++)
+    {
+        pthread_t thread;
+
+        (void)pthread_create(&thread, NULL, &coreThread, (void*)(uintptr_t)core);
+    }
+#endif
+
+    // Switch to the first task, its entry unmasks the interrupt signals
+    (void)setcontext((ucontext_t*)Tasks[Current_Task].psp);
+}
+
+
+void PendSV_Handler(void)
+{
+    uint32 previousTask;
+    uint32 stackMarker;
+
+    if (!Scheduler_Started)
+        return;
+
+#if NUM_CORES > 1
+    // Held across the switch, released by the task switched in, here or in taskEntry()
+    kernelLock();
+#endif
+
+    previousTask = Current_Task;
+
+    // The handler runs on the stack of the task being switched out
+    TaskStackPointer[previousTask] = &stackMarker;
+
+    schedule();
+
+    // Save the running context and resume the next one, skipped if the same task was selected
+    if (previousTask != Current_Task)
+        (void)swapcontext((ucontext_t*)Tasks[previousTask].psp, (ucontext_t*)Tasks[Current_Task].psp);
+
+#if NUM_CORES > 1
+    kernelUnlock();
+#endif
+}
+
+void SysTick_Handler(void)
+{
+#if NUM_CORES > 1
+    kernelLock();
+#endif
+
+    // Increment SysTick counter for scheduling purposes, by the reloads whose signal the host dropped too
+    tickIncrement(STK_getReloadsPending());
+
+    TRACE_RECORD(TRACE_TICK, Current_Task, (uint16)SysTick);
+
+    // Wake the due tasks, a task woken for another core has already been signalled to it
+    boolean preempted = checkBlockedTasks();
+
+#if NUM_CORES > 1
+    uint32 switchCores = 0;
+
+    // Every core charges the tick to its time slice
+    for (uint32 core = 0; core < NUM_CORES; core++)
+    {
+        if (tickSwitchRequired(core, preempted && core == THIS_CORE))
+            switchCores |= 1UL << core;
+    }
+
+    kernelUnlock();
+
+    for (uint32 core = 0; core < NUM_CORES; core++)
+    {
+        if (switchCores & (1UL << core))
+            triggerCorePendSV(core);
+    }
+#else
+    // Enable PendSV interrupt to trigger context switch only when the running task gives way
+    if (tickSwitchRequired(0, preempted))
+        enablePENDSV();
+#endif
+}
+
+
+void disableInterrupts(void)
+{
+    (void)sigprocmask(SIG_BLOCK, &InterruptSignals, NULL);
+}
+
+void enableInterrupts(void)
+{
+    (void)sigprocmask(SIG_UNBLOCK, &InterruptSignals, NULL);
+}
+
+uint32 disableInterruptsFromISR(void)
+{
+    sigset_t previous;
+
+    (void)sigprocmask(SIG_BLOCK, &InterruptSignals, &previous);
+
+#if NUM_CORES > 1
+    kernelLock();
+#endif
+
+    return (uint32)sigismember(&previous, STK_SIGNAL);
+}
+
+void restoreInterruptsFromISR(uint32 state)
+{
+#if NUM_CORES > 1
+    kernelUnlock();
+#endif
+
+    if (!state)
+        enableInterrupts();
+}
+
+void waitForInterrupt(void)
+{
+    int signalNumber;
+
+    // Consume the signal and pend it again, the handler runs once the signals are unblocked
+    if (sigwait(&InterruptSignals, &signalNumber) == 0)
+        (void)raise(signalNumber);
+}
+
+void triggerPendSV(void)
+{
+    (void)raise(PENDSV_SIGNAL);
+}
+
+
+void enableSystemFaults(void)
+{
+    struct sigaction action = {0};
+
+    // Faults run on their own stack so a task stack overflow can still be reported
+    installFaultStack();
+    Faults_Enabled = TRUE;
+
+    sigfillset(&action.sa_mask);
+    action.sa_flags   = SA_ONSTACK;
+    action.sa_handler = &Fault_SignalHandler;
+
+    (void)sigaction(SIGSEGV, &action, NULL);
+    (void)sigaction(SIGBUS,  &action, NULL);
+    (void)sigaction(SIGILL,  &action, NULL);
+    (void)sigaction(SIGFPE,  &action, NULL);
+}
+
+
+// The tick and switch signals are masked together with the ISR signals, no priority to set.
+void initKernelInterrupts(void)
+{
+}
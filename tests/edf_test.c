@@ -0,0 +1,139 @@
+/**
+ ******************************************************************************
+ * File           : edf_test.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Linux host (POSIX port)
+ * Brief          : Earliest deadline first: deadline tasks admitted up to a
+ *                  total density of 1 and rejected above it, the density of
+ *                  a deleted task given back, inconsistent timings rejected,
+ *                  and jobs released on the same tick run earliest deadline
+ *                  first. Built and run by run_tests.sh (EDF).
+ ******************************************************************************
+ */
+
+#include <LIB/std_types.h>
+
+#include "test.h"
+
+
+#if SCHEDULE_ALGORITHM != EDF
+#error "edf_test.c needs the EDF scheduler"
+#endif
+
+#define TEST_PRIORITY               1                       // Below every deadline task
+
+#define PERIOD                      10
+#define JOBS                        4
+
+
+static Task_Handler_t Late, Early;
+
+// Tasks in the order their jobs ran, 'E' or 'L'
+static volatile char Order[2 * JOBS];
+static volatile uint32 OrderCount;
+
+
+static void idleJob(void)
+{
+}
+
+static void lateJob(void)
+{
+    if (OrderCount < 2 * JOBS)
+        Order[OrderCount++] = 'L';
+}
+
+static void earlyJob(void)
+{
+    if (OrderCount < 2 * JOBS)
+        Order[OrderCount++] = 'E';
+}
+
+
+static void testInvalid(void)
+{
+    check(OS_createDeadlineTask(NULL, NULL, "T", 1024, PERIOD, PERIOD, 1) == OS_TASK_NULL_FUNC, "deadline task without a job");
+
+    check(OS_createDeadlineTask(NULL, &idleJob, "T", 1024, 0, PERIOD, 1) == OS_TASK_INVALID_PERIOD
+          && OS_createDeadlineTask(NULL, &idleJob, "T", 1024, PERIOD, PERIOD, 0) == OS_TASK_INVALID_PERIOD,
+          "deadline task with a period or an execution time of 0");
+
+    check(OS_createDeadlineTask(NULL, &idleJob, "T", 1024, PERIOD, 4, 5) == OS_TASK_INVALID_PERIOD
+          && OS_createDeadlineTask(NULL, &idleJob, "T", 1024, 4, PERIOD, 5) == OS_TASK_INVALID_PERIOD,
+          "deadline task whose job exceeds its deadline or period");
+}
+
+
+static void testAdmission(void)
+{
+    Task_Handler_t x, y, z;
+    OS_TaskError_t error;
+
+    // 6/10 + 4/min(10, 20): exactly 1
+    check(OS_createDeadlineTask(&x, &idleJob, "X", 1024, PERIOD, PERIOD, 6) == OS_TASK_SUCCESS, "X admitted at density 0.6");
+    check(OS_createDeadlineTask(&y, &idleJob, "Y", 1024, 2 * PERIOD, PERIOD, 4) == OS_TASK_SUCCESS,
+          "Y admitted at density 0.4 from its deadline, total 1");
+
+    error = OS_createDeadlineTask(&z, &idleJob, "Z", 1024, 10 * PERIOD, 10 * PERIOD, 1);
+    check(error == OS_TASK_NOT_SCHEDULABLE, "Z at density 0.01 rejected above a total of 1: error %d", error);
+
+    // Deleting Y gives its density back
+    os_deleteTask(y);
+    error = OS_createDeadlineTask(&z, &idleJob, "Z", 1024, 10 * PERIOD, 10 * PERIOD, 1);
+    check(error == OS_TASK_SUCCESS, "Z admitted once Y is deleted: error %d", error);
+
+    os_deleteTask(x);
+    os_deleteTask(z);
+}
+
+
+static void testOrder(void)
+{
+    boolean earlyFirst = TRUE;
+
+    // Created on the same tick, every next job of both is released together
+    os_delay(1);
+    (void)OS_createDeadlineTask(&Late, &lateJob, "LATE", 1024, PERIOD, 8, 1);
+    (void)OS_createDeadlineTask(&Early, &earlyJob, "EARLY", 1024, PERIOD, 3, 1);
+    check(Late->wakeTime == Early->wakeTime, "next jobs of both released on tick %u", Early->wakeTime);
+
+    os_delay(JOBS * PERIOD - PERIOD / 2);
+
+    // The first jobs ran as the tasks were created, every next pair earliest deadline first
+    for (uint32 i = 2; i + 1 < OrderCount; i += 2)
+    {
+        if (Order[i] != 'E' || Order[i + 1] != 'L')
+            earlyFirst = FALSE;
+    }
+
+    check(OrderCount == 2 * JOBS && Order[0] == 'L' && earlyFirst, "%u jobs released together ran earliest deadline first: %.*s",
+          OrderCount, (int)OrderCount, (const char*)Order);
+
+    check(os_getTaskOverruns(Late) == 0 && os_getTaskOverruns(Early) == 0, "no job missed its period");
+
+    os_deleteTask(Late);
+    os_deleteTask(Early);
+}
+
+
+static void testTask(void)
+{
+    testInvalid();
+    testAdmission();
+    testOrder();
+
+    finish();
+}
+
+
+int main(void)
+{
+    os_init();
+
+    (void)OS_createTask(NULL, &testTask, "TEST", TEST_PRIORITY, 1024);
+
+    os_start();
+
+    return 0;
+}
@@ -0,0 +1,218 @@
+/**
+ ******************************************************************************
+ * File           : mutex_test.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Linux host (POSIX port)
+ * Brief          : Mutexes: recursive locks, busy and not owner paths, the
+ *                  owner raised to the priority of its waiters and restored
+ *                  on unlock or once a waiter times out, the handover to the
+ *                  highest priority waiter, and a waiter suspended while
+ *                  blocked never handed the mutex. Built and run by
+ *                  run_tests.sh (PRIORITY_PREEMPTIVE).
+ ******************************************************************************
+ */
+
+#include <LIB/std_types.h>
+#include <Kernel/Mutex.h>
+#include <Kernel/Notify.h>
+
+#include "test.h"
+
+
+#define TEST_PRIORITY               1                       // The workers run above the test task
+
+#define LOW_PRIORITY                (TEST_PRIORITY + 1)
+#define MEDIUM_PRIORITY             (TEST_PRIORITY + 2)
+#define HIGH_PRIORITY               (TEST_PRIORITY + 3)
+
+#define LOCK_TIMEOUT                5
+
+// Commands notified to the workers
+#define CMD_LOCK                    1                       // Lock, waiting for ever
+#define CMD_LOCK_TIMEOUT            2                       // Lock, waiting up to LOCK_TIMEOUT ticks
+#define CMD_UNLOCK                  3
+
+
+// A task locking and unlocking the mutex on command
+typedef struct Worker_t
+{
+    Task_Handler_t task;
+    volatile OS_MutexError_t error;     // Result of the last command
+    volatile uint32 done;               // Number of commands completed
+} Worker_t;
+
+
+static Mutex_t Mutex;
+
+static Worker_t Low, Medium, High;
+
+
+// Run the commands notified to a worker, one at a time
+static void runWorker(Worker_t *worker)
+{
+    for (;;)
+    {
+        uint32 command;
+
+        (void)os_notifyWait(0, 0xFFFFFFFF, &command, OS_WAIT_FOREVER);
+
+        if (command == CMD_UNLOCK)
+            worker->error = os_mutexUnlock(&Mutex);
+        else
+            worker->error = os_mutexLock(&Mutex, command == CMD_LOCK ? OS_WAIT_FOREVER : LOCK_TIMEOUT);
+
+        worker->done++;
+    }
+}
+
+static void lowWorker(void)     { runWorker(&Low); }
+static void mediumWorker(void)  { runWorker(&Medium); }
+static void highWorker(void)    { runWorker(&High); }
+
+
+// The workers run above the test task, a command is carried out or blocked on return
+static void command(Worker_t *worker, uint32 cmd)
+{
+    (void)os_notify(worker->task, cmd, OS_NOTIFY_OVERWRITE);
+}
+
+
+static void testOwner(void)
+{
+    OS_MutexError_t error;
+
+    check(os_mutexUnlock(&Mutex) == OS_MUTEX_NOT_OWNER, "unlock of a free mutex");
+
+    (void)os_mutexLock(&Mutex, OS_NO_WAIT);
+    error = os_mutexLock(&Mutex, OS_NO_WAIT);
+    check(error == OS_MUTEX_SUCCESS && Mutex.lockCount == 2, "owner locks the mutex again: error %d, %u locks", error, Mutex.lockCount);
+
+    (void)os_mutexUnlock(&Mutex);
+    check(Mutex.owner != NULL, "mutex still owned after the first of two unlocks");
+
+    (void)os_mutexUnlock(&Mutex);
+    check(Mutex.owner == NULL, "mutex free after the last unlock");
+
+    command(&Low, CMD_LOCK);
+    check(Mutex.owner == Low.task && os_mutexLock(&Mutex, OS_NO_WAIT) == OS_MUTEX_BUSY, "lock of a mutex owned by another task");
+
+    command(&Low, CMD_UNLOCK);
+}
+
+
+static void testInheritance(void)
+{
+    command(&Low, CMD_LOCK);
+
+    command(&High, CMD_LOCK);
+    check(TASK_IS_BLOCKED(High.task) && Low.task->priority == HIGH_PRIORITY,
+          "owner raised to the priority of its waiter: %u", Low.task->priority);
+
+    command(&Low, CMD_UNLOCK);
+    check(Mutex.owner == High.task && High.done == 1 && High.error == OS_MUTEX_SUCCESS && Low.task->priority == LOW_PRIORITY,
+          "unlock hands the mutex over to the waiter and restores the owner: priority %u", Low.task->priority);
+
+    command(&High, CMD_UNLOCK);
+
+    // A waiter giving up no longer raises the owner
+    command(&Low, CMD_LOCK);
+    command(&High, CMD_LOCK_TIMEOUT);
+    check(Low.task->priority == HIGH_PRIORITY, "owner raised while the waiter waits up to %u ticks", LOCK_TIMEOUT);
+
+    os_delay(2 * LOCK_TIMEOUT);
+    check(High.done == 3 && High.error == OS_MUTEX_TIMEOUT && Low.task->priority == LOW_PRIORITY,
+          "waiter times out and the owner is restored: error %d, priority %u", High.error, Low.task->priority);
+
+    command(&Low, CMD_UNLOCK);
+}
+
+
+static void testHandover(void)
+{
+    uint32 highDone = High.done, mediumDone = Medium.done;
+
+    // Low owns, Medium then High wait, High is first in line
+    command(&Low, CMD_LOCK);
+    command(&Medium, CMD_LOCK);
+    command(&High, CMD_LOCK);
+    check(Low.task->priority == HIGH_PRIORITY, "owner raised to the highest of its waiters: %u", Low.task->priority);
+
+    command(&Low, CMD_UNLOCK);
+    check(Mutex.owner == High.task && High.done == highDone + 1 && Medium.done == mediumDone,
+          "unlock hands the mutex over to the highest priority waiter");
+
+    command(&High, CMD_UNLOCK);
+    check(Mutex.owner == Medium.task && Medium.done == mediumDone + 1, "next unlock hands it over to the next waiter");
+
+    command(&Medium, CMD_UNLOCK);
+}
+
+
+static void testSuspendedWaiter(void)
+{
+    uint32 highDone = High.done, mediumDone = Medium.done;
+
+    command(&Low, CMD_LOCK);
+    command(&Medium, CMD_LOCK);
+    command(&High, CMD_LOCK);
+
+    os_suspendTask(High.task);
+
+    command(&Low, CMD_UNLOCK);
+    check(Mutex.owner == Medium.task && Medium.done == mediumDone + 1 && High.done == highDone,
+          "unlock with High suspended hands the mutex over to Medium");
+
+    // Resumed, High waits again and raises the new owner
+    os_resumeTask(High.task);
+    check(TASK_IS_BLOCKED(High.task) && Medium.task->priority == HIGH_PRIORITY,
+          "resumed High waits again and raises the owner: priority %u", Medium.task->priority);
+
+    command(&Medium, CMD_UNLOCK);
+    check(Mutex.owner == High.task && High.done == highDone + 1 && Medium.task->priority == MEDIUM_PRIORITY,
+          "next unlock hands the mutex over to High");
+
+    command(&High, CMD_UNLOCK);
+
+    // With its single waiter suspended the mutex is left free, the waiter takes it once resumed
+    command(&Low, CMD_LOCK);
+    command(&High, CMD_LOCK);
+    os_suspendTask(High.task);
+
+    command(&Low, CMD_UNLOCK);
+    check(Mutex.owner == NULL, "mutex left free while its waiter is suspended");
+
+    os_resumeTask(High.task);
+    check(Mutex.owner == High.task && High.done == highDone + 3 && High.error == OS_MUTEX_SUCCESS,
+          "resumed High checks the mutex again and takes it");
+
+    command(&High, CMD_UNLOCK);
+}
+
+
+static void testTask(void)
+{
+    (void)OS_createTask(&Low.task, &lowWorker, "LOW", LOW_PRIORITY, 1024);
+    (void)OS_createTask(&Medium.task, &mediumWorker, "MEDIUM", MEDIUM_PRIORITY, 1024);
+    (void)OS_createTask(&High.task, &highWorker, "HIGH", HIGH_PRIORITY, 1024);
+
+    testOwner();
+    testInheritance();
+    testHandover();
+    testSuspendedWaiter();
+
+    finish();
+}
+
+
+int main(void)
+{
+    os_init();
+
+    (void)os_mutexCreate(&Mutex);
+    (void)OS_createTask(NULL, &testTask, "TEST", TEST_PRIORITY, 1024);
+
+    os_start();
+
+    return 0;
+}
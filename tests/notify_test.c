@@ -0,0 +1,177 @@
+/**
+ ******************************************************************************
+ * File           : notify_test.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Linux host (POSIX port)
+ * Brief          : Direct to task notifications: empty, timeout and invalid
+ *                  paths, set bits, overwrite and increment pending before a
+ *                  wait, clear on entry and on exit, a waiter and a taker
+ *                  blocked then woken from a task and from an ISR, and the
+ *                  counting take. Built and run by run_tests.sh
+ *                  (PRIORITY_PREEMPTIVE).
+ ******************************************************************************
+ */
+
+#include <LIB/std_types.h>
+#include <Kernel/Notify.h>
+
+#include "test.h"
+
+
+#define TEST_PRIORITY               1                       // The waiters run above the test task
+
+#define WAIT_TIMEOUT                20
+#define LOW_BYTE                    0xFF
+
+
+static Task_Handler_t Self, Waiter, Taker;
+
+// Result of the last wait of the waiter and the number of its waits
+static volatile OS_NotifyError_t WaitError;
+static volatile uint32 WaitValue, Waits;
+
+// Value returned by the last take of the taker and the number of its takes
+static volatile uint32 Taken, Takes;
+
+
+// Wait up to WAIT_TIMEOUT ticks, the low byte cleared once notified
+static void waiter(void)
+{
+    for (;;)
+    {
+        uint32 value;
+
+        WaitError = os_notifyWait(0, LOW_BYTE, &value, WAIT_TIMEOUT);
+        WaitValue = value;
+        Waits++;
+    }
+}
+
+// Take one give at a time for ever
+static void taker(void)
+{
+    for (;;)
+    {
+        Taken = os_notifyTake(FALSE, OS_WAIT_FOREVER);
+        Takes++;
+    }
+}
+
+
+static void testEmpty(void)
+{
+    uint32 value = 0xFFFFFFFF, start;
+    OS_NotifyError_t error;
+
+    check(os_notifyWait(0, 0, &value, OS_NO_WAIT) == OS_NOTIFY_EMPTY && value == 0, "wait without a notification and no time");
+
+    start = os_getTickCount();
+    error = os_notifyWait(0, 0, &value, 5);
+    check(error == OS_NOTIFY_TIMEOUT && os_getTickCount() - start >= 5, "wait times out after 5 ticks: error %d, %u ticks",
+          error, os_getTickCount() - start);
+
+    start = os_getTickCount();
+    value = os_notifyTake(FALSE, 5);
+    check(value == 0 && os_getTickCount() - start >= 5, "take times out after 5 ticks with 0");
+
+    check(os_notify(NULL, 1, OS_NOTIFY_SET_BITS) == OS_NOTIFY_INVALID
+          && os_notify(Self, 1, (OS_NotifyAction_t)(OS_NOTIFY_OVERWRITE + 1)) == OS_NOTIFY_INVALID,
+          "notify a NULL task or with an unknown action");
+}
+
+
+static void testPending(void)
+{
+    OS_NotifyError_t error;
+    uint32 value;
+
+    // Notified before the wait, it returns at once
+    (void)os_notify(Self, 0x10, OS_NOTIFY_SET_BITS);
+    (void)os_notifyFromISR(Self, 0x01, OS_NOTIFY_SET_BITS);
+    error = os_notifyWait(0, 0x01, &value, OS_NO_WAIT);
+    check(error == OS_NOTIFY_SUCCESS && value == 0x11 && Self->notifyValue == 0x10,
+          "set bits accumulate, only the clear on exit bits are cleared: 0x%x left", Self->notifyValue);
+
+    (void)os_notify(Self, 0x05, OS_NOTIFY_OVERWRITE);
+    check(os_notifyWait(0, 0xFFFFFFFF, &value, OS_NO_WAIT) == OS_NOTIFY_SUCCESS && value == 0x05 && Self->notifyValue == 0,
+          "overwrite replaces the value");
+
+    // Without a pending notification, clear on entry applies before the wait
+    Self->notifyValue = 0x30;
+    check(os_notifyWait(0x10, 0, &value, OS_NO_WAIT) == OS_NOTIFY_EMPTY && value == 0x20, "clear on entry without a notification");
+    Self->notifyValue = 0;
+
+    // Counting: a take decrements the value or clears it
+    for (uint32 i = 0; i < 3; i++)
+        (void)os_notifyGive(Self);
+
+    value = os_notifyTake(FALSE, OS_NO_WAIT);
+    check(value == 3 && Self->notifyValue == 2, "take returns 3 gives and leaves 2");
+
+    value = os_notifyTake(TRUE, OS_NO_WAIT);
+    check(value == 2 && Self->notifyValue == 0, "take clearing on exit takes all of them");
+}
+
+
+static void testWaiter(void)
+{
+    uint32 waits;
+
+    (void)OS_createTask(&Waiter, &waiter, "WAITER", TEST_PRIORITY + 1, 1024);
+    check(TASK_IS_BLOCKED(Waiter) && Waits == 0, "waiter blocked without a notification");
+
+    (void)os_notify(Waiter, 0x102, OS_NOTIFY_SET_BITS);
+    check(Waits == 1 && WaitError == OS_NOTIFY_SUCCESS && WaitValue == 0x102 && Waiter->notifyValue == 0x100,
+          "notify wakes the waiter at once, the low byte cleared on exit: 0x%x", WaitValue);
+
+    (void)os_notifyFromISR(Waiter, 0x03, OS_NOTIFY_SET_BITS);
+    check(Waits == 2 && WaitValue == 0x103, "notify from an ISR wakes the waiter: 0x%x", WaitValue);
+
+    // Nothing more, the wait expires with the value not cleared
+    waits = Waits;
+    os_delay(WAIT_TIMEOUT + WAIT_TIMEOUT / 2);
+    check(Waits == waits + 1 && WaitError == OS_NOTIFY_TIMEOUT && WaitValue == 0x100, "waiter times out: error %d, 0x%x",
+          WaitError, WaitValue);
+
+    os_deleteTask(Waiter);
+    check(os_notify(Waiter, 1, OS_NOTIFY_SET_BITS) == OS_NOTIFY_INVALID, "notify a deleted task");
+}
+
+
+static void testTaker(void)
+{
+    (void)OS_createTask(&Taker, &taker, "TAKER", TEST_PRIORITY + 1, 1024);
+    check(TASK_IS_BLOCKED(Taker) && Takes == 0, "taker blocked on a value of 0");
+
+    (void)os_notifyGive(Taker);
+    check(Takes == 1 && Taken == 1 && Taker->notifyValue == 0, "give wakes the taker");
+
+    (void)os_notifyGiveFromISR(Taker);
+    check(Takes == 2 && Taken == 1 && TASK_IS_BLOCKED(Taker), "give from an ISR wakes the taker, it waits again");
+
+    os_deleteTask(Taker);
+}
+
+
+static void testTask(void)
+{
+    testEmpty();
+    testPending();
+    testWaiter();
+    testTaker();
+
+    finish();
+}
+
+
+int main(void)
+{
+    os_init();
+
+    (void)OS_createTask(&Self, &testTask, "TEST", TEST_PRIORITY, 1024);
+
+    os_start();
+
+    return 0;
+}
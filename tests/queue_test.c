@@ -0,0 +1,230 @@
+/**
+ ******************************************************************************
+ * File           : queue_test.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Linux host (POSIX port)
+ * Brief          : Message queues: empty/full and timeout paths, a receiver
+ *                  and a sender blocked then woken, FIFO order across the
+ *                  wrap of the ring indices with copies and in place
+ *                  (reserve/commit, acquire/release), and a waiter suspended
+ *                  while blocked never swallowing the wake-up of the next
+ *                  one. Built and run by run_tests.sh (PRIORITY_PREEMPTIVE).
+ ******************************************************************************
+ */
+
+#include <string.h>
+
+#include <LIB/std_types.h>
+#include <Kernel/Queue.h>
+
+#include "test.h"
+
+
+#define QUEUE_LENGTH                4
+#define WRAP_ROUNDS                 (3 * QUEUE_LENGTH + 1)   // Not a multiple of the length
+
+#define TEST_PRIORITY               1                       // The waiters run above the test task
+
+
+static Queue_t Queue;
+static uint32 Storage[QUEUE_LENGTH];
+
+static Task_Handler_t WaiterA, WaiterB;
+
+// Last element received and number of receptions of every waiter
+static volatile uint32 ReceivedA, ReceivedB, CountA, CountB;
+static volatile OS_QueueError_t LastError;
+static volatile boolean SenderDone;
+
+
+// Receive for ever, a task blocked on the queue as long as it is empty
+static void waiterA(void)
+{
+    for (;;)
+    {
+        uint32 item;
+
+        LastError = os_queueReceive(&Queue, &item, OS_WAIT_FOREVER);
+        ReceivedA = item;
+        CountA++;
+    }
+}
+
+static void waiterB(void)
+{
+    for (;;)
+    {
+        uint32 item;
+
+        LastError = os_queueReceive(&Queue, &item, OS_WAIT_FOREVER);
+        ReceivedB = item;
+        CountB++;
+    }
+}
+
+
+// Fill the queue, then send one more for ever, blocked until the test task receives
+static void sender(void)
+{
+    for (uint32 i = 0; i < QUEUE_LENGTH + 1; i++)
+        (void)os_queueSend(&Queue, &i, OS_WAIT_FOREVER);
+
+    SenderDone = TRUE;
+
+    for (;;)
+        os_delay(1000);
+}
+
+
+static void testTimeouts(void)
+{
+    uint32 item = 0, start;
+    OS_QueueError_t error;
+
+    check(os_queueReceive(&Queue, &item, OS_NO_WAIT) == OS_QUEUE_EMPTY, "receive from an empty queue without waiting");
+
+    start = os_getTickCount();
+    error = os_queueReceive(&Queue, &item, 5);
+    check(error == OS_QUEUE_TIMEOUT && os_getTickCount() - start >= 5, "receive times out after 5 ticks: error %d, %u ticks",
+          error, os_getTickCount() - start);
+
+    for (uint32 i = 0; i < QUEUE_LENGTH; i++)
+        (void)os_queueSend(&Queue, &i, OS_NO_WAIT);
+
+    check(os_queueSend(&Queue, &item, OS_NO_WAIT) == OS_QUEUE_FULL, "send to a full queue without waiting");
+
+    start = os_getTickCount();
+    error = os_queueSend(&Queue, &item, 5);
+    check(error == OS_QUEUE_TIMEOUT && os_getTickCount() - start >= 5, "send times out after 5 ticks: error %d, %u ticks",
+          error, os_getTickCount() - start);
+
+    while (os_queueReceive(&Queue, &item, OS_NO_WAIT) == OS_QUEUE_SUCCESS);
+}
+
+
+static void testWrap(void)
+{
+    uint32 next = 0, expected = 0, count;
+    boolean inOrder = TRUE;
+
+    // Half full all along, the head and tail indices wrap several times
+    for (uint32 round = 0; round < WRAP_ROUNDS; round++)
+    {
+        void *slot;
+        uint32 item;
+
+        (void)os_queueSend(&Queue, &next, OS_NO_WAIT);
+        next++;
+
+        if (os_queueReserve(&Queue, &slot, OS_NO_WAIT) == OS_QUEUE_SUCCESS)
+        {
+            memcpy(slot, &next, sizeof(next));
+            os_queueCommit(&Queue);
+            next++;
+        }
+
+        if (os_queueReceive(&Queue, &item, OS_NO_WAIT) != OS_QUEUE_SUCCESS || item != expected++)
+            inOrder = FALSE;
+
+        if (os_queueAcquire(&Queue, &slot, OS_NO_WAIT) != OS_QUEUE_SUCCESS || *(uint32*)slot != expected++)
+            inOrder = FALSE;
+        else
+            os_queueRelease(&Queue);
+    }
+
+    count = os_queueGetCount(&Queue);
+    check(inOrder && count == 0, "FIFO order of %u elements through a ring of %u, copied and in place, %u left",
+          WRAP_ROUNDS * 2, QUEUE_LENGTH, count);
+}
+
+
+static void testBlockedWaiters(void)
+{
+    uint32 item = 7;
+    Task_Handler_t senderTask;
+
+    (void)OS_createTask(&WaiterA, &waiterA, "A", TEST_PRIORITY + 2, 1024);
+
+    // A runs right away and blocks on the empty queue
+    check(TASK_IS_BLOCKED(WaiterA), "receiver blocked on the empty queue");
+
+    (void)os_queueSend(&Queue, &item, OS_NO_WAIT);
+    check(CountA == 1 && ReceivedA == 7 && LastError == OS_QUEUE_SUCCESS && TASK_IS_BLOCKED(WaiterA),
+          "send wakes the blocked receiver, it preempts the sender and waits again");
+
+    os_suspendTask(WaiterA);
+
+    // A sender blocked on the full queue is woken by a receive
+    (void)OS_createTask(&senderTask, &sender, "SEND", TEST_PRIORITY + 1, 1024);
+    check(!SenderDone && TASK_IS_BLOCKED(senderTask) && os_queueGetCount(&Queue) == QUEUE_LENGTH,
+          "sender blocked on the full queue");
+
+    (void)os_queueReceive(&Queue, &item, OS_NO_WAIT);
+    check(SenderDone && os_queueGetCount(&Queue) == QUEUE_LENGTH, "receive wakes the blocked sender");
+
+    os_deleteTask(senderTask);
+
+    while (os_queueReceive(&Queue, &item, OS_NO_WAIT) == OS_QUEUE_SUCCESS);
+
+    CountA = 0;
+    os_resumeTask(WaiterA);
+}
+
+
+static void testSuspendedWaiter(void)
+{
+    uint32 item = 11;
+
+    // A (the higher priority, head of the wait list) and B both wait on the empty queue
+    (void)OS_createTask(&WaiterB, &waiterB, "B", TEST_PRIORITY + 1, 1024);
+    check(TASK_IS_BLOCKED(WaiterA) && TASK_IS_BLOCKED(WaiterB), "A and B blocked on the empty queue");
+
+    os_suspendTask(WaiterA);
+
+    (void)os_queueSend(&Queue, &item, OS_NO_WAIT);
+    check(CountB == 1 && ReceivedB == 11 && CountA == 0 && os_queueGetCount(&Queue) == 0,
+          "send with A suspended wakes B: B received %u times, A %u times, %u left", CountB, CountA, os_queueGetCount(&Queue));
+
+    // Resumed, A waits again and is first in line
+    os_resumeTask(WaiterA);
+    item = 12;
+    (void)os_queueSend(&Queue, &item, OS_NO_WAIT);
+    check(CountA == 1 && ReceivedA == 12 && CountB == 1, "resumed A waits again and gets the next element");
+
+    // With every waiter suspended the element stays, the first one resumed takes it
+    os_suspendTask(WaiterA);
+    os_suspendTask(WaiterB);
+    item = 13;
+    (void)os_queueSend(&Queue, &item, OS_NO_WAIT);
+    check(os_queueGetCount(&Queue) == 1, "element kept while every waiter is suspended");
+
+    os_resumeTask(WaiterB);
+    check(CountB == 2 && ReceivedB == 13 && os_queueGetCount(&Queue) == 0, "resumed B checks the queue again and receives it");
+
+    os_resumeTask(WaiterA);
+}
+
+
+static void testTask(void)
+{
+    testTimeouts();
+    testWrap();
+    testBlockedWaiters();
+    testSuspendedWaiter();
+
+    finish();
+}
+
+
+int main(void)
+{
+    os_init();
+
+    (void)os_queueCreate(&Queue, Storage, sizeof(Storage[0]), QUEUE_LENGTH);
+    (void)OS_createTask(NULL, &testTask, "TEST", TEST_PRIORITY, 1024);
+
+    os_start();
+
+    return 0;
+}
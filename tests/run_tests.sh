@@ -0,0 +1,63 @@
+#!/bin/sh
+#
+# File           : run_tests.sh
+# Author         : Ibrahim Diab
+# Target         : Linux host (POSIX port)
+# Brief          : Build the kernel with the POSIX port and the tests of this
+#                  directory, run them and report PASS/FAIL. Exits non zero
+#                  when a test fails.
+#
+# Usage: tests/run_tests.sh
+#        CC and CFLAGS override the compiler and its flags.
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+BUILD=$(mktemp -d)
+trap 'rm -rf "$BUILD"' EXIT
+
+# Build and run a test: run_test <test.c> <configuration name> <sed script applied to kernel_cfg.h>
+run_test()
+{
+    rm -rf "$BUILD/kernel"
+
+    # Same layout as for any other port (port/POSIX_GCC_PORT/README.txt)
+    cp -r "$ROOT/kernel" "$BUILD/"
+    cp -r "$ROOT/port/POSIX_GCC_PORT/Inc/Kernel/port" "$BUILD/kernel/Inc/Kernel/port"
+    mkdir -p "$BUILD/kernel/Src/Kernel/kernel_port"
+    cp -r "$ROOT/port/POSIX_GCC_PORT/Src/Kernel_port/"* "$BUILD/kernel/Src/Kernel/kernel_port/"
+    ln -s Kernel "$BUILD/kernel/Inc/kernel"
+
+    sed -i -e "$3" "$BUILD/kernel/Inc/Kernel/kernel_cfg.h"
+
+    echo "== $(basename "$1" .c) ($2)"
+
+    (cd "$BUILD" && ${CC:-gcc} -std=gnu99 ${CFLAGS:--O2} -Wall -Wextra -Ikernel/Src -Ikernel/Inc \
+        $(find kernel/Src -name '*.c') "$1" -o test -lrt)
+
+    # A lost wake-up hangs a test rather than failing a check
+    timeout 120 "$BUILD/test"
+}
+
+PREEMPTIVE="s/^#define SCHEDULE_ALGORITHM .*/#define SCHEDULE_ALGORITHM          PRIORITY_PREEMPTIVE/"
+
+TICKLESS="$PREEMPTIVE; \
+          s/^#define TICKLESS_IDLE .*/#define TICKLESS_IDLE               ENABLED/; \
+          s/^#define STACK_PAINTING .*/#define STACK_PAINTING              ENABLED/; \
+          s/^#define STACK_OVERFLOW_CHECK .*/#define STACK_OVERFLOW_CHECK        ENABLED/"
+
+run_test "$ROOT/tests/tickless_test.c" "tickless idle" "$TICKLESS"
+run_test "$ROOT/tests/tickless_test.c" "periodic tick" "s/^#define TICKLESS_IDLE .*/#define TICKLESS_IDLE               DISABLED/"
+run_test "$ROOT/tests/queue_test.c" "priority preemptive" "$PREEMPTIVE"
+run_test "$ROOT/tests/semaphore_test.c" "priority preemptive" "$PREEMPTIVE"
+run_test "$ROOT/tests/mutex_test.c" "priority preemptive" "$PREEMPTIVE"
+run_test "$ROOT/tests/notify_test.c" "priority preemptive" "$PREEMPTIVE"
+run_test "$ROOT/tests/stream_test.c" "priority preemptive" "$PREEMPTIVE"
+run_test "$ROOT/tests/workqueue_test.c" "4 slots ring" "$PREEMPTIVE; \
+          s/^#define WORK_QUEUE .*/#define WORK_QUEUE                  ENABLED/; \
+          s/^#define WORK_QUEUE_LENGTH .*/#define WORK_QUEUE_LENGTH           4/; \
+          s/^#define WORK_QUEUE_PRIORITY .*/#define WORK_QUEUE_PRIORITY         1/"
+run_test "$ROOT/tests/timer_test.c" "software timers" "$PREEMPTIVE; \
+          s/^#define SOFTWARE_TIMERS .*/#define SOFTWARE_TIMERS             ENABLED/"
+run_test "$ROOT/tests/smp_test.c" "2 cores" "$PREEMPTIVE; s/^#define NUM_CORES .*/#define NUM_CORES                   2/"
+run_test "$ROOT/tests/edf_test.c" "earliest deadline first" "s/^#define SCHEDULE_ALGORITHM .*/#define SCHEDULE_ALGORITHM          EDF/"
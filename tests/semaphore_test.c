@@ -0,0 +1,218 @@
+/**
+ ******************************************************************************
+ * File           : semaphore_test.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Linux host (POSIX port)
+ * Brief          : Counting semaphores and event groups: empty, overflow and
+ *                  timeout paths, blocked takers and flag waiters woken, any
+ *                  and all waits with clear on exit, a taker of the giver's
+ *                  priority left for its turn, and a waiter suspended
+ *                  while blocked never taking the unit or the flags of the
+ *                  next one. Built and run by run_tests.sh
+ *                  (PRIORITY_PREEMPTIVE).
+ ******************************************************************************
+ */
+
+#include <LIB/std_types.h>
+#include <Kernel/Semaphore.h>
+#include <Kernel/EventGroup.h>
+
+#include "test.h"
+
+
+#define TEST_PRIORITY               1                       // The waiters run above the test task
+
+#define FLAG_A                      0x01
+#define FLAG_B                      0x02
+#define FLAG_C                      0x04
+
+
+static Semaphore_t Semaphore;
+static EventGroup_t Group;
+
+static Task_Handler_t TakerA, TakerB, TakerC, FlagWaiter;
+
+// Units taken by every taker
+static volatile uint32 TakenA, TakenB, TakenC;
+
+// Result of the last wait of the flag waiter and the number of its waits
+static volatile OS_EventError_t FlagError;
+static volatile uint32 FlagBits, FlagWaits;
+
+
+// Take units for ever, a task blocked on the semaphore as long as it is empty
+static void takerA(void)
+{
+    for (;;)
+    {
+        if (os_semaphoreTake(&Semaphore, OS_WAIT_FOREVER) == OS_SEMAPHORE_SUCCESS)
+            TakenA++;
+    }
+}
+
+static void takerB(void)
+{
+    for (;;)
+    {
+        if (os_semaphoreTake(&Semaphore, OS_WAIT_FOREVER) == OS_SEMAPHORE_SUCCESS)
+            TakenB++;
+    }
+}
+
+static void takerC(void)
+{
+    for (;;)
+    {
+        if (os_semaphoreTake(&Semaphore, OS_WAIT_FOREVER) == OS_SEMAPHORE_SUCCESS)
+            TakenC++;
+    }
+}
+
+
+// Wait for all of A and B, clearing them on exit, up to 20 ticks
+static void flagWaiter(void)
+{
+    for (;;)
+    {
+        uint32 bits;
+
+        FlagError = os_eventGroupWait(&Group, FLAG_A | FLAG_B, OS_EVENT_WAIT_ALL | OS_EVENT_CLEAR_ON_EXIT, 20, &bits);
+        FlagBits  = bits;
+        FlagWaits++;
+    }
+}
+
+
+static void testSemaphoreCounts(void)
+{
+    OS_SemaphoreError_t error;
+    uint32 start;
+
+    check(os_semaphoreTake(&Semaphore, OS_NO_WAIT) == OS_SEMAPHORE_EMPTY, "take from an empty semaphore without waiting");
+
+    start = os_getTickCount();
+    error = os_semaphoreTake(&Semaphore, 5);
+    check(error == OS_SEMAPHORE_TIMEOUT && os_getTickCount() - start >= 5, "take times out after 5 ticks: error %d, %u ticks",
+          error, os_getTickCount() - start);
+
+    (void)os_semaphoreGive(&Semaphore);
+    (void)os_semaphoreGiveFromISR(&Semaphore);
+    error = os_semaphoreGive(&Semaphore);
+    check(error == OS_SEMAPHORE_OVERFLOW && os_semaphoreGetCount(&Semaphore) == 2, "give above the maximum count overflows");
+
+    check(os_semaphoreTake(&Semaphore, OS_NO_WAIT) == OS_SEMAPHORE_SUCCESS && os_semaphoreTakeFromISR(&Semaphore) == OS_SEMAPHORE_SUCCESS
+          && os_semaphoreGetCount(&Semaphore) == 0, "both units taken back");
+}
+
+
+static void testSemaphoreWaiters(void)
+{
+    // A (the higher priority, head of the wait list) and B both wait on the empty semaphore
+    (void)OS_createTask(&TakerA, &takerA, "A", TEST_PRIORITY + 2, 1024);
+    (void)OS_createTask(&TakerB, &takerB, "B", TEST_PRIORITY + 1, 1024);
+    check(TASK_IS_BLOCKED(TakerA) && TASK_IS_BLOCKED(TakerB), "A and B blocked on the empty semaphore");
+
+    (void)os_semaphoreGive(&Semaphore);
+    check(TakenA == 1 && TakenB == 0 && os_semaphoreGetCount(&Semaphore) == 0, "give wakes the highest priority taker");
+
+    os_suspendTask(TakerA);
+
+    (void)os_semaphoreGive(&Semaphore);
+    check(TakenB == 1 && TakenA == 1 && os_semaphoreGetCount(&Semaphore) == 0,
+          "give with A suspended wakes B: B took %u units, A %u, %u left", TakenB, TakenA, os_semaphoreGetCount(&Semaphore));
+
+    // With every taker suspended the unit stays, the first one resumed takes it
+    os_suspendTask(TakerB);
+    (void)os_semaphoreGive(&Semaphore);
+    check(os_semaphoreGetCount(&Semaphore) == 1, "unit kept while every taker is suspended");
+
+    os_resumeTask(TakerA);
+    check(TakenA == 2 && os_semaphoreGetCount(&Semaphore) == 0, "resumed A checks the semaphore again and takes it");
+
+    os_resumeTask(TakerB);
+    os_deleteTask(TakerA);
+    os_deleteTask(TakerB);
+
+    // A taker of the same priority as the giver waits for its turn, it does not cut the time slice
+    (void)OS_createTask(&TakerC, &takerC, "C", TEST_PRIORITY, 1024);
+    os_delay(1);
+    check(TASK_IS_BLOCKED(TakerC), "C of the test task priority blocked on the empty semaphore");
+
+    (void)os_semaphoreGive(&Semaphore);
+    check(TakenC == 0, "give to a taker of the same priority keeps the giver running");
+
+    os_delay(1);
+    check(TakenC == 1, "C takes the unit once the giver blocks");
+
+    os_deleteTask(TakerC);
+}
+
+
+static void testEventGroup(void)
+{
+    OS_EventError_t error;
+    uint32 bits, start;
+
+    (void)os_eventGroupSet(&Group, FLAG_C);
+
+    error = os_eventGroupWait(&Group, FLAG_A | FLAG_C, OS_EVENT_WAIT_ANY, OS_NO_WAIT, &bits);
+    check(error == OS_EVENT_SUCCESS && bits == FLAG_C, "wait for any flag released by one set flag");
+
+    start = os_getTickCount();
+    error = os_eventGroupWait(&Group, FLAG_A | FLAG_C, OS_EVENT_WAIT_ALL, 5, &bits);
+    check(error == OS_EVENT_TIMEOUT && bits == FLAG_C && os_getTickCount() - start >= 5,
+          "wait for all flags times out after 5 ticks with the flags set: error %d, bits 0x%x", error, bits);
+
+    (void)os_eventGroupClear(&Group, FLAG_C);
+
+    // The waiter is released once both flags are set and clears them
+    (void)OS_createTask(&FlagWaiter, &flagWaiter, "FLAGS", TEST_PRIORITY + 1, 1024);
+    (void)os_eventGroupSet(&Group, FLAG_A);
+    check(FlagWaits == 0 && TASK_IS_BLOCKED(FlagWaiter), "waiter for all flags still blocked with one set");
+
+    (void)os_eventGroupSetFromISR(&Group, FLAG_B);
+    check(FlagWaits == 1 && FlagError == OS_EVENT_SUCCESS && FlagBits == (FLAG_A | FLAG_B) && os_eventGroupGetBits(&Group) == 0,
+          "waiter released by the last flag, the flags cleared on exit");
+
+    // Suspended while waiting, the flags set meanwhile release it once resumed
+    os_suspendTask(FlagWaiter);
+    (void)os_eventGroupSet(&Group, FLAG_A | FLAG_B);
+    check(FlagWaits == 1 && os_eventGroupGetBits(&Group) == (FLAG_A | FLAG_B), "flags kept while the waiter is suspended");
+
+    os_resumeTask(FlagWaiter);
+    check(FlagWaits == 2 && FlagError == OS_EVENT_SUCCESS && os_eventGroupGetBits(&Group) == 0,
+          "resumed waiter checks the flags again and is released");
+
+    // Suspended past its timeout, it reports the timeout once resumed
+    os_suspendTask(FlagWaiter);
+    os_delay(30);
+    os_resumeTask(FlagWaiter);
+    check(FlagWaits == 3 && FlagError == OS_EVENT_TIMEOUT, "waiter resumed after its timeout reports it: error %d", FlagError);
+
+    os_deleteTask(FlagWaiter);
+}
+
+
+static void testTask(void)
+{
+    testSemaphoreCounts();
+    testSemaphoreWaiters();
+    testEventGroup();
+
+    finish();
+}
+
+
+int main(void)
+{
+    os_init();
+
+    (void)os_semaphoreCreate(&Semaphore, 0, 2);
+    (void)os_eventGroupCreate(&Group);
+    (void)OS_createTask(NULL, &testTask, "TEST", TEST_PRIORITY, 1024);
+
+    os_start();
+
+    return 0;
+}
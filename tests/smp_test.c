@@ -0,0 +1,205 @@
+/**
+ ******************************************************************************
+ * File           : smp_test.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Linux host (POSIX port)
+ * Brief          : Two cores: a task runs only on the cores of its affinity
+ *                  and follows a change of it, an idle core steals a task
+ *                  waiting on a busy one, and a task deleted while it runs on
+ *                  the other core stops there and its slot is reused. Built
+ *                  and run by run_tests.sh (NUM_CORES 2, PRIORITY_PREEMPTIVE).
+ ******************************************************************************
+ */
+
+#include <LIB/std_types.h>
+
+#include "test.h"
+
+
+#if NUM_CORES != 2
+#error "smp_test.c needs NUM_CORES 2"
+#endif
+
+#define TEST_PRIORITY               3                       // Above the spinners, so the test task always gets a core
+#define SPIN_PRIORITY               2
+
+#define CORE_0                      0x01
+#define CORE_1                      0x02
+#define BOTH_CORES                  (CORE_0 | CORE_1)
+
+// Every core is a host thread, on a busy host one may wait several ticks for a CPU
+#define SETTLE_TIMEOUT              1000                    // Ticks a spinner gets to show up on the cores it is moved to
+#define SAMPLE_TICKS                50
+
+
+// A task busy for ever, never blocking, counting its loops on every core
+typedef struct Spinner_t
+{
+    Task_Handler_t task;
+    volatile uint32 runs[NUM_CORES];    // Written by the spinner only, on the core it runs on
+} Spinner_t;
+
+
+static Spinner_t A, B, C;
+
+static Task_Handler_t Sleeper;
+
+
+static void spin(Spinner_t *spinner)
+{
+    for (;;)
+        spinner->runs[os_getCoreId()]++;
+}
+
+static void spinnerA(void)  { spin(&A); }
+static void spinnerB(void)  { spin(&B); }
+static void spinnerC(void)  { spin(&C); }
+
+
+static void sleeper(void)
+{
+    for (;;)
+        os_delay(1000);
+}
+
+
+// Loops of a spinner on the cores of a mask, bit n for core n
+static uint32 runsOn(const Spinner_t *spinner, uint32 cores)
+{
+    uint32 total = 0;
+
+    for (uint32 core = 0; core < NUM_CORES; core++)
+    {
+        if (cores & (1UL << core))
+            total += spinner->runs[core];
+    }
+
+    return total;
+}
+
+
+/* Wait until a spinner runs on one of the cores of a mask. A count of the core it left,
+   read before it was switched out, is written once it runs again, so that core is quiet
+   from then on. */
+static void settle(const Spinner_t *spinner, uint32 cores)
+{
+    uint32 runs = runsOn(spinner, cores);
+
+    for (uint32 tick = 0; tick < SETTLE_TIMEOUT && runsOn(spinner, cores) == runs; tick++)
+        os_delay(1);
+}
+
+
+// Cores a spinner runs on over SAMPLE_TICKS once it showed up on the expected ones, bit n for core n
+static uint32 sampleCores(const Spinner_t *spinner, uint32 expected)
+{
+    uint32 before[NUM_CORES], cores = 0;
+
+    settle(spinner, expected);
+
+    for (uint32 core = 0; core < NUM_CORES; core++)
+        before[core] = spinner->runs[core];
+
+    os_delay(SAMPLE_TICKS);
+
+    for (uint32 core = 0; core < NUM_CORES; core++)
+    {
+        if (spinner->runs[core] != before[core])
+            cores |= 1UL << core;
+    }
+
+    return cores;
+}
+
+
+static void testAffinity(void)
+{
+    uint32 seen;
+
+    check(os_setTaskAffinity(A.task, 0) == OS_TASK_INVALID_AFFINITY && os_setTaskAffinity(A.task, 0x04) == OS_TASK_INVALID_AFFINITY,
+          "affinity without a core or with a missing core rejected");
+
+    (void)os_setTaskAffinity(A.task, CORE_1);
+    seen = sampleCores(&A, CORE_1);
+    check(seen == CORE_1, "task pinned to core 1 runs there only: cores 0x%x", seen);
+
+    (void)os_setTaskAffinity(A.task, CORE_0);
+    seen = sampleCores(&A, CORE_0);
+    check(seen == CORE_0, "task moved to core 0 at its next switch: cores 0x%x", seen);
+}
+
+
+static void testStealing(void)
+{
+    uint32 seen;
+
+    // B waits behind A on core 0, then may run on both
+    (void)OS_createTask(&B.task, &spinnerB, "B", SPIN_PRIORITY, 1024);
+    (void)os_setTaskAffinity(B.task, CORE_0);
+    seen = sampleCores(&B, CORE_0);
+    check(seen == CORE_0 && B.task->core == 0, "B sharing core 0 with A: cores 0x%x", seen);
+
+    // Core 1 is left idle while the test task waits, it takes B over
+    (void)os_setTaskAffinity(B.task, BOTH_CORES);
+    seen = sampleCores(&B, CORE_1);
+    check((seen & CORE_1) != 0 && B.task->core == 1 && A.task->core == 0,
+          "idle core 1 steals B from busy core 0: cores 0x%x", seen);
+}
+
+
+static void testRemoteDelete(void)
+{
+    uint32 otherCore, runs;
+    Spinner_t *remote;
+
+    // A and B each own a core, the one away from the test task keeps running
+    (void)os_setTaskAffinity(B.task, CORE_1);
+    settle(&B, CORE_1);
+
+    otherCore = 1 - os_getCoreId();
+    remote    = (otherCore == 0) ? &A : &B;
+
+    settle(remote, 1UL << otherCore);
+    check(remote->task->core == otherCore, "spinner running on core %u away from the test task", otherCore);
+
+    os_deleteTask(remote->task);
+
+    // C takes the core over once it switched away from the deleted task
+    (void)OS_createTask(&C.task, &spinnerC, "C", SPIN_PRIORITY, 1024);
+    (void)os_setTaskAffinity(C.task, 1UL << otherCore);
+    settle(&C, 1UL << otherCore);
+
+    runs = runsOn(remote, BOTH_CORES);
+    os_delay(SAMPLE_TICKS);
+    check(runsOn(remote, BOTH_CORES) == runs && remote->task->state == DELETED && runsOn(&C, 1UL << otherCore) != 0,
+          "task deleted while running on core %u stops there, C runs in its place", otherCore);
+
+    // Reclaimed by the core it ran on, its control block is the next one handed out
+    (void)OS_createTask(&Sleeper, &sleeper, "SLEEP", SPIN_PRIORITY, 1024);
+    check(Sleeper == remote->task, "control block of the deleted task reused");
+}
+
+
+static void testTask(void)
+{
+    (void)OS_createTask(&A.task, &spinnerA, "A", SPIN_PRIORITY, 1024);
+
+    testAffinity();
+    testStealing();
+    testRemoteDelete();
+
+    finish();
+}
+
+
+int main(void)
+{
+    os_init();
+
+    (void)OS_createTask(NULL, &testTask, "TEST", TEST_PRIORITY, 1024);
+
+    os_start();
+
+    return 0;
+}
@@ -0,0 +1,275 @@
+/**
+ ******************************************************************************
+ * File           : stream_test.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Linux host (POSIX port)
+ * Brief          : Stream buffers: invalid, empty, full and timeout paths,
+ *                  byte order across the wrap of the ring and of the free
+ *                  running 32-bit counters with copies and in place
+ *                  (reserve/commit, acquire/release), a reader woken at its
+ *                  trigger level and by a lowered one, and a writer woken by
+ *                  free space. Built and run by run_tests.sh
+ *                  (PRIORITY_PREEMPTIVE).
+ ******************************************************************************
+ */
+
+#include <LIB/std_types.h>
+#include <Kernel/StreamBuffer.h>
+
+#include "test.h"
+
+
+#define TEST_PRIORITY               1                       // The reader and writer run above the test task
+
+#define STREAM_SIZE                 16
+#define TRIGGER_LEVEL               4
+#define WRAP_BYTES                  (40 * STREAM_SIZE)
+#define COUNTERS_NEAR_WRAP          (0xFFFFFFFFUL - 2 * STREAM_SIZE)
+#define WRITER_BYTES                (STREAM_SIZE + STREAM_SIZE / 2)
+
+
+static StreamBuffer_t Stream;
+static uint8 Storage[STREAM_SIZE];
+
+static Task_Handler_t Reader, Writer;
+
+// Bytes of the last receive of the reader and the number of its receives
+static uint8 ReadData[STREAM_SIZE];
+static volatile uint32 ReadCount, Reads;
+
+static volatile uint32 Written;
+static volatile boolean WriterDone;
+
+
+static void reader(void)
+{
+    for (;;)
+    {
+        ReadCount = os_streamReceive(&Stream, ReadData, sizeof(ReadData), OS_WAIT_FOREVER);
+        Reads++;
+    }
+}
+
+// Send more than the stream holds, blocked until the test task reads
+static void writer(void)
+{
+    uint8 data[WRITER_BYTES];
+
+    for (uint32 i = 0; i < WRITER_BYTES; i++)
+        data[i] = (uint8)i;
+
+    Written    = os_streamSend(&Stream, data, WRITER_BYTES, OS_WAIT_FOREVER);
+    WriterDone = TRUE;
+
+    for (;;)
+        os_delay(1000);
+}
+
+
+static void testInvalid(void)
+{
+    StreamBuffer_t stream;
+
+    check(os_streamCreate(&stream, Storage, 12, 1) == OS_STREAM_INVALID && os_streamCreate(&stream, NULL, STREAM_SIZE, 1) == OS_STREAM_INVALID,
+          "create with a size not a power of 2 or without storage");
+
+    check(os_streamCreate(&stream, Storage, STREAM_SIZE, 0) == OS_STREAM_INVALID
+          && os_streamCreate(&stream, Storage, STREAM_SIZE, STREAM_SIZE + 1) == OS_STREAM_INVALID,
+          "create with a trigger level of 0 or above the size");
+}
+
+
+static void testLimits(void)
+{
+    uint8 data[STREAM_SIZE + 4] = {0};
+    uint32 length, start;
+
+    check(os_streamReceive(&Stream, data, sizeof(data), OS_NO_WAIT) == 0, "receive from an empty stream without waiting");
+
+    start  = os_getTickCount();
+    length = os_streamReceive(&Stream, data, sizeof(data), 5);
+    check(length == 0 && os_getTickCount() - start >= 5, "receive times out after 5 ticks: %u ticks", os_getTickCount() - start);
+
+    // Below the trigger level, what arrived is returned once the wait expires
+    (void)os_streamSend(&Stream, data, TRIGGER_LEVEL - 1, OS_NO_WAIT);
+    start  = os_getTickCount();
+    length = os_streamReceive(&Stream, data, sizeof(data), 5);
+    check(length == TRIGGER_LEVEL - 1 && os_getTickCount() - start >= 5, "receive below the trigger level returns %u bytes at the timeout",
+          length);
+
+    length = os_streamSend(&Stream, data, sizeof(data), OS_NO_WAIT);
+    check(length == STREAM_SIZE && os_streamGetSpace(&Stream) == 0, "send of %u bytes without waiting fills the %u bytes",
+          (uint32)sizeof(data), STREAM_SIZE);
+
+    start  = os_getTickCount();
+    length = os_streamSend(&Stream, data, 1, 5);
+    check(length == 0 && os_getTickCount() - start >= 5, "send to a full stream times out after 5 ticks");
+
+    length = os_streamReceive(&Stream, data, sizeof(data), OS_NO_WAIT);
+    check(length == STREAM_SIZE && os_streamGetCount(&Stream) == 0, "receive takes the whole stream");
+}
+
+
+// Stream bytes through, sent by 7 and received by 5 so the ring offsets never line up
+static boolean streamBytes(uint32 bytes)
+{
+    uint8 next = 0, expected = 0, data[7];
+    uint32 sent = 0, received = 0;
+    boolean inOrder = TRUE;
+
+    while (received < bytes)
+    {
+        uint8 *slot;
+        uint32 length;
+
+        // Copied in, or written in place up to the end of the ring
+        if (sent < bytes && (sent / 7) % 2 == 0)
+        {
+            for (uint32 i = 0; i < sizeof(data); i++)
+                data[i] = (uint8)(next + i);
+
+            length = os_streamSendFromISR(&Stream, data, (bytes - sent < sizeof(data)) ? bytes - sent : sizeof(data));
+        }
+        else if (sent < bytes)
+        {
+            length = os_streamReserve(&Stream, &slot, OS_NO_WAIT);
+
+            if (length > 7)
+                length = 7;
+
+            if (length > bytes - sent)
+                length = bytes - sent;
+
+            for (uint32 i = 0; i < length; i++)
+                slot[i] = (uint8)(next + i);
+
+            os_streamCommit(&Stream, length);
+        }
+        else
+            length = 0;
+
+        next += (uint8)length;
+        sent += length;
+
+        // Copied out, or read in place up to the end of the ring
+        if ((received / 5) % 2 == 0)
+        {
+            length = os_streamReceiveFromISR(&Stream, data, 5);
+
+            for (uint32 i = 0; i < length; i++)
+                if (data[i] != expected++)
+                    inOrder = FALSE;
+        }
+        else
+        {
+            length = os_streamAcquire(&Stream, &slot, OS_NO_WAIT);
+
+            if (length > 5)
+                length = 5;
+
+            for (uint32 i = 0; i < length; i++)
+                if (slot[i] != expected++)
+                    inOrder = FALSE;
+
+            os_streamRelease(&Stream, length);
+        }
+
+        received += length;
+    }
+
+    return inOrder && os_streamGetCount(&Stream) == 0;
+}
+
+
+static void testWrap(void)
+{
+    boolean inOrder;
+
+    check(streamBytes(WRAP_BYTES), "byte order of %u bytes through a ring of %u, copied and in place", WRAP_BYTES, STREAM_SIZE);
+
+    // Empty with the free running counters just below their wrap
+    Stream.head = COUNTERS_NEAR_WRAP;
+    Stream.tail = COUNTERS_NEAR_WRAP;
+
+    inOrder = streamBytes(8 * STREAM_SIZE);
+    check(inOrder && Stream.tail < COUNTERS_NEAR_WRAP, "byte order kept across the wrap of the 32-bit counters, tail now %u",
+          Stream.tail);
+}
+
+
+static void testReader(void)
+{
+    uint8 data[TRIGGER_LEVEL] = {1, 2, 3, 4};
+
+    (void)OS_createTask(&Reader, &reader, "READER", TEST_PRIORITY + 1, 1024);
+    check(TASK_IS_BLOCKED(Reader) && Reads == 0, "reader blocked on the empty stream");
+
+    (void)os_streamSend(&Stream, data, TRIGGER_LEVEL - 1, OS_NO_WAIT);
+    check(Reads == 0 && TASK_IS_BLOCKED(Reader), "reader still blocked below its trigger level");
+
+    (void)os_streamSend(&Stream, &data[TRIGGER_LEVEL - 1], 1, OS_NO_WAIT);
+    check(Reads == 1 && ReadCount == TRIGGER_LEVEL && ReadData[0] == 1 && ReadData[TRIGGER_LEVEL - 1] == 4,
+          "reader woken at its trigger level with %u bytes", ReadCount);
+
+    // A lower trigger level releases a reader waiting for more
+    (void)os_streamSend(&Stream, data, 2, OS_NO_WAIT);
+    check(Reads == 1, "reader blocked with 2 bytes");
+
+    (void)os_streamSetTriggerLevel(&Stream, 2);
+    check(Reads == 2 && ReadCount == 2, "lowering the trigger level to 2 wakes the reader");
+
+    (void)os_streamSetTriggerLevel(&Stream, TRIGGER_LEVEL);
+    os_deleteTask(Reader);
+}
+
+
+static void testWriter(void)
+{
+    uint8 data[STREAM_SIZE];
+    uint32 length;
+    boolean inOrder = TRUE;
+
+    (void)OS_createTask(&Writer, &writer, "WRITER", TEST_PRIORITY + 1, 1024);
+    check(!WriterDone && TASK_IS_BLOCKED(Writer) && os_streamGetSpace(&Stream) == 0, "writer blocked on the full stream");
+
+    // Every read frees space, the writer goes on at once
+    length = os_streamReceive(&Stream, data, STREAM_SIZE / 2, OS_NO_WAIT);
+    check(WriterDone && Written == WRITER_BYTES && os_streamGetCount(&Stream) == STREAM_SIZE,
+          "read of %u bytes lets the writer send the rest", length);
+
+    length = os_streamReceive(&Stream, data, sizeof(data), OS_NO_WAIT);
+
+    for (uint32 i = 0; i < length; i++)
+        if (data[i] != (uint8)(STREAM_SIZE / 2 + i))
+            inOrder = FALSE;
+
+    check(length == STREAM_SIZE && inOrder, "bytes sent across the wait in order");
+
+    os_deleteTask(Writer);
+}
+
+
+static void testTask(void)
+{
+    testInvalid();
+    testLimits();
+    testWrap();
+    testReader();
+    testWriter();
+
+    finish();
+}
+
+
+int main(void)
+{
+    os_init();
+
+    (void)os_streamCreate(&Stream, Storage, STREAM_SIZE, TRIGGER_LEVEL);
+    (void)OS_createTask(NULL, &testTask, "TEST", TEST_PRIORITY, 1024);
+
+    os_start();
+
+    return 0;
+}
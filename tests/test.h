@@ -0,0 +1,65 @@
+/**
+ ******************************************************************************
+ * File           : test.h
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Linux host (POSIX port)
+ * Brief          : Checks shared by the tests of this directory. A test runs
+ *                  in kernel tasks, prints PASS or FAIL for every check and
+ *                  ends with PASSED or FAILED, exiting non zero on a failure.
+ ******************************************************************************
+ */
+#ifndef TESTS_TEST_H_
+#define TESTS_TEST_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+#include <LIB/std_types.h>
+#include <Kernel/kernel_cfg.h>
+#include <Kernel/kernel_interface.h>
+#include <Kernel/port/port.h>
+#include <Kernel/Task.h>
+
+
+static uint32 Failures;
+
+
+// Whether a task is blocked on a delay or a kernel object
+#define TASK_IS_BLOCKED(task)       ((task)->state == BLOCKED)
+
+
+// Report a check, printf is not async-signal-safe so the kernel signals are masked around it
+static void __attribute__((format(printf, 2, 3), unused)) check(boolean passed, const char *format, ...)
+{
+    va_list args;
+
+    DISABLE_INTERRUPTS();
+
+    printf("%s ", passed ? "PASS" : "FAIL");
+
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+
+    printf("\n");
+    fflush(stdout);
+
+    ENABLE_INTERRUPTS();
+
+    if (!passed)
+        Failures++;
+}
+
+
+// Report the result of the test and end it, called from a task
+static void __attribute__((noreturn, unused)) finish(void)
+{
+    DISABLE_INTERRUPTS();
+    printf("%s\n", Failures ? "FAILED" : "PASSED");
+    exit(Failures ? 1 : 0);
+}
+
+
+#endif /* TESTS_TEST_H_ */
@@ -0,0 +1,179 @@
+/**
+ ******************************************************************************
+ * File           : tickless_test.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Linux host (POSIX port)
+ * Brief          : Tick accounting of the tickless idle mode: a task working
+ *                  part of a tick then delaying must not make the tick count
+ *                  drift from the wall clock, os_getTimeNs and os_getTimeUs
+ *                  must never go backwards across idle entry and exit (also
+ *                  read from an ISR waking the idle task early) and the idle
+ *                  task must stay within its stack. Built and run by
+ *                  run_tests.sh.
+ ******************************************************************************
+ */
+
+#include <signal.h>
+#include <time.h>
+
+
+#include "test.h"
+
+
+#define WORK_NS                     600000      // Part of a tick worked before every delay
+#define DELAY_TICKS                 5
+#define ROUNDS                      200
+
+#define MAX_DRIFT_PERCENT           2           // Tick count against the wall clock
+#define MAX_DRIFT_MS                5           // Start and end latency of the host timer
+
+#define ISR_PERIOD_NS               170000      // Not a divisor of the tick, wakes the idle task mid-tick
+
+
+extern volatile Task_t Tasks[];
+
+static timer_t IsrTimer;
+static uint64 IsrLastNs, IsrLastUs;
+static volatile uint32 IsrBackSteps, IsrReads;
+static volatile uint32 OverflowDetected;
+
+
+// Wall clock in nanoseconds
+static uint64 wallNs(void)
+{
+    struct timespec time;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (uint64)time.tv_sec * 1000000000ULL + (uint64)time.tv_nsec;
+}
+
+
+#if STACK_OVERFLOW_CHECK == ENABLED
+void os_stackOverflowHook(Task_Handler_t taskhandler)
+{
+    (void)taskhandler;
+
+    OverflowDetected++;
+}
+#endif
+
+
+// Read the kernel time in nanoseconds and microseconds, returns 1 when either went back since the last read
+static uint32 readTime(uint64 *lastNs, uint64 *lastUs)
+{
+    uint64 timeNs = os_getTimeNs();
+    uint64 timeUs = os_getTimeUs();
+    uint32 backStep = (timeNs < *lastNs || timeUs < *lastUs);
+
+    *lastNs = timeNs;
+    *lastUs = timeUs;
+
+    return backStep;
+}
+
+
+static void isrHandler(void)
+{
+    IsrBackSteps += readTime(&IsrLastNs, &IsrLastUs);
+    IsrReads++;
+}
+
+
+// Busy work of about nanoSec, reading the kernel time all along. Returns the number of back steps seen.
+static uint32 work(uint64 nanoSec, uint64 *lastNs, uint64 *lastUs)
+{
+    uint64 end = wallNs() + nanoSec;
+    uint32 backSteps = 0;
+
+    while (wallNs() < end)
+        backSteps += readTime(lastNs, lastUs);
+
+    return backSteps;
+}
+
+
+// Work part of a tick then delay, the tick count has to follow the wall clock
+static void runRounds(const char *name, uint64 *lastNs, uint64 *lastUs, uint32 *backSteps)
+{
+    uint64 wallStart, wallMs, timeStart, timeMs;
+    uint32 tickStart, ticks, allowed;
+
+    // Start on a tick boundary
+    os_delay(1);
+
+    wallStart = wallNs();
+    tickStart = os_getTickCount();
+    timeStart = os_getTimeNs();
+
+    for (uint32 round = 0; round < ROUNDS; round++)
+    {
+        *backSteps += work(WORK_NS, lastNs, lastUs);
+
+        os_delay(DELAY_TICKS);
+
+        // The idle task slept during the delay
+        *backSteps += readTime(lastNs, lastUs);
+    }
+
+    wallMs = (wallNs() - wallStart) / 1000000;
+    ticks  = (os_getTickCount() - tickStart) * SYSTEM_TICK;
+    timeMs = (os_getTimeNs() - timeStart) / 1000000;
+
+    allowed = (uint32)(wallMs * MAX_DRIFT_PERCENT / 100) + MAX_DRIFT_MS;
+
+    check((ticks > wallMs ? ticks - wallMs : wallMs - ticks) <= allowed, "%s: %u ticks, os_getTimeNs %llu ms, wall clock %llu ms",
+          name, ticks, (unsigned long long)timeMs, (unsigned long long)wallMs);
+}
+
+
+static void testTask(void)
+{
+    struct itimerspec period = {{0, ISR_PERIOD_NS}, {0, ISR_PERIOD_NS}};
+    struct itimerspec stop = {{0, 0}, {0, 0}};
+    uint64 lastNs = 0, lastUs = 0;
+    uint32 backSteps = 0;
+
+    runRounds("tick count follows the wall clock", &lastNs, &lastUs, &backSteps);
+
+    // An ISR wakes the idle task in the middle of its sleeps and reads the time
+    (void)timer_settime(IsrTimer, 0, &period, NULL);
+    runRounds("tick count follows the wall clock with early wake-ups", &lastNs, &lastUs, &backSteps);
+    (void)timer_settime(IsrTimer, 0, &stop, NULL);
+
+    check(backSteps == 0 && IsrBackSteps == 0 && IsrReads > 0,
+          "os_getTimeNs and os_getTimeUs never decrease: %u back steps in the task, %u in %u ISR reads",
+          backSteps, IsrBackSteps, IsrReads);
+
+#if STACK_PAINTING == ENABLED
+    check(os_getStackHighWaterMark((Task_t*)&Tasks[0]) < GET_STACK_SIZE(&Tasks[0]),
+          "idle task stack: %u bytes used at most", os_getStackHighWaterMark((Task_t*)&Tasks[0]));
+#endif
+
+#if STACK_OVERFLOW_CHECK == ENABLED
+    check(OverflowDetected == 0, "no stack overflow detected");
+#endif
+
+    finish();
+}
+
+
+int main(void)
+{
+    struct sigevent event = {0};
+
+    os_init();
+
+    installInterruptHandler(SIGRTMIN, &isrHandler);
+
+    event.sigev_notify = SIGEV_SIGNAL;
+    event.sigev_signo  = SIGRTMIN;
+    (void)timer_create(CLOCK_MONOTONIC, &event, &IsrTimer);
+
+    (void)OS_createTask(NULL, &testTask, "TEST", 1, 1024);
+
+    os_start();
+
+    return 0;
+}
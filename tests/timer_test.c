@@ -0,0 +1,197 @@
+/**
+ ******************************************************************************
+ * File           : timer_test.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Linux host (POSIX port)
+ * Brief          : Software timers: invalid paths, a one-shot timer expiring
+ *                  once on its tick, reset and stop, and an auto-reload timer
+ *                  staying in phase over many periods, also after a callback
+ *                  run late and after whole periods were missed. Built and
+ *                  run by run_tests.sh (SOFTWARE_TIMERS).
+ ******************************************************************************
+ */
+
+#include <LIB/std_types.h>
+#include <Kernel/kernel_cfg.h>
+#include <Kernel/Timer.h>
+
+#include "test.h"
+
+
+#if SOFTWARE_TIMERS != ENABLED
+#error "timer_test.c needs SOFTWARE_TIMERS"
+#endif
+
+#define TEST_PRIORITY               1
+
+#define PERIOD                      10
+#define PERIODS                     20
+#define LATE_TICKS                  3                       // Less than a period
+#define MISSED_TICKS                (2 * PERIOD + 2)        // Whole periods
+
+
+static Timer_t OneShot, Periodic, Blocker;
+
+/* Expiry tick of every run of the periodic timer and of the one-shot timer, and the tick the
+   callback ran on. The daemon may run a callback late on a busy host, the expiry ticks tell
+   the drift apart from that. */
+static volatile uint32 PeriodicExpiries[PERIODS], PeriodicRuns[PERIODS];
+static volatile uint32 PeriodicCount, OneShotExpiry, OneShotRun, OneShotCount;
+
+
+static void oneShot(void *argument)
+{
+    (void)argument;
+
+    OneShotExpiry = OneShot.node.value;
+    OneShotRun    = os_getTickCount();
+    OneShotCount++;
+}
+
+// The next expiry is set before the callback runs
+static void periodic(void *argument)
+{
+    (void)argument;
+
+    if (PeriodicCount < PERIODS)
+    {
+        PeriodicExpiries[PeriodicCount] = Periodic.node.value - PERIOD;
+        PeriodicRuns[PeriodicCount]     = os_getTickCount();
+    }
+
+    PeriodicCount++;
+}
+
+// Hold the daemon for the ticks given as argument, the timers due meanwhile run late
+static void blocker(void *argument)
+{
+    uint32 start = os_getTickCount();
+
+    while (os_getTickCount() - start < (uint32)(uintptr_t)argument);
+}
+
+
+static void testInvalid(void)
+{
+    Timer_t timer;
+
+    check(os_timerInit(NULL, &oneShot, NULL, FALSE) == OS_TIMER_INVALID && os_timerInit(&timer, NULL, NULL, FALSE) == OS_TIMER_INVALID,
+          "init without a timer or a function");
+
+    (void)os_timerInit(&timer, &oneShot, NULL, FALSE);
+    check(os_timerStart(&timer, 0) == OS_TIMER_INVALID && os_timerReset(&timer) == OS_TIMER_INVALID && !os_timerIsActive(&timer),
+          "start for 0 ticks and reset of a timer never started");
+}
+
+
+static void testOneShot(void)
+{
+    uint32 start;
+
+    os_delay(1);
+    start = os_getTickCount();
+    (void)os_timerStart(&OneShot, PERIOD);
+    check(os_timerIsActive(&OneShot), "one-shot timer active once started");
+
+    os_delay(3 * PERIOD);
+    check(OneShotCount == 1 && OneShotExpiry == start + PERIOD && OneShotRun >= OneShotExpiry && !os_timerIsActive(&OneShot),
+          "one-shot timer expires once, %u ticks after its start", OneShotExpiry - start);
+
+    // Reset restarts it for its period from now, a restart pushes the expiry back
+    start = os_getTickCount();
+    (void)os_timerReset(&OneShot);
+    os_delay(PERIOD - 2);
+    (void)os_timerStart(&OneShot, PERIOD);
+    os_delay(3 * PERIOD);
+    check(OneShotCount == 2 && OneShotExpiry == start + 2 * PERIOD - 2, "restarted timer expires %u ticks after the reset",
+          OneShotExpiry - start);
+
+    // Stopped before it expires, it never does
+    (void)os_timerStart(&OneShot, PERIOD);
+    (void)os_timerStop(&OneShot);
+    os_delay(2 * PERIOD);
+    check(OneShotCount == 2 && !os_timerIsActive(&OneShot), "stopped timer does not expire");
+}
+
+
+static void testPhase(void)
+{
+    uint32 start, late;
+    boolean inPhase = TRUE;
+
+    os_delay(1);
+    start = os_getTickCount();
+    (void)os_timerStart(&Periodic, PERIOD);
+
+    // Hold the daemon over the 3rd expiry, it runs late and the next ones stay in phase
+    Blocker.argument = (void*)(uintptr_t)LATE_TICKS;
+    (void)os_timerStart(&Blocker, 3 * PERIOD - 1);
+
+    os_delay(PERIODS * PERIOD + PERIOD / 2);
+
+    for (uint32 i = 0; i < PERIODS; i++)
+    {
+        if (PeriodicExpiries[i] != start + (i + 1) * PERIOD || PeriodicRuns[i] < PeriodicExpiries[i])
+            inPhase = FALSE;
+    }
+
+    late = PeriodicRuns[2] - PeriodicExpiries[2];
+    check(PeriodicCount == PERIODS && inPhase && late >= LATE_TICKS - 1,
+          "%u expiries every %u ticks without drift, the one held back run %u ticks late", PeriodicCount, PERIOD, late);
+}
+
+
+static void testMissed(void)
+{
+    uint32 start, count;
+
+    (void)os_timerStop(&Periodic);
+    PeriodicCount = 0;
+
+    // Held for whole periods from before its first expiry, it starts over from the late run instead of catching up
+    os_delay(1);
+    start = os_getTickCount();
+    (void)os_timerStart(&Periodic, PERIOD);
+
+    Blocker.argument = (void*)(uintptr_t)MISSED_TICKS;
+    (void)os_timerStart(&Blocker, PERIOD - 1);
+
+    os_delay(PERIOD - 1 + MISSED_TICKS + 2 * PERIOD + PERIOD / 2);
+    check(PeriodicCount == 3 && PeriodicExpiries[0] >= start + PERIOD - 1 + MISSED_TICKS
+          && PeriodicExpiries[1] == PeriodicExpiries[0] + PERIOD && PeriodicExpiries[2] == PeriodicExpiries[1] + PERIOD,
+          "missed periods skipped, not run back to back: %u runs, the first %u ticks late", PeriodicCount,
+          PeriodicExpiries[0] - (start + PERIOD));
+
+    (void)os_timerStop(&Periodic);
+    count = PeriodicCount;
+    os_delay(2 * PERIOD);
+    check(PeriodicCount == count && !os_timerIsActive(&Periodic), "stopped auto-reload timer does not expire again");
+}
+
+
+static void testTask(void)
+{
+    testInvalid();
+    testOneShot();
+    testPhase();
+    testMissed();
+
+    finish();
+}
+
+
+int main(void)
+{
+    os_init();
+
+    (void)os_timerInit(&OneShot, &oneShot, NULL, FALSE);
+    (void)os_timerInit(&Periodic, &periodic, NULL, TRUE);
+    (void)os_timerInit(&Blocker, &blocker, NULL, FALSE);
+
+    (void)OS_createTask(NULL, &testTask, "TEST", TEST_PRIORITY, 1024);
+
+    os_start();
+
+    return 0;
+}
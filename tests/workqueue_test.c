@@ -0,0 +1,183 @@
+/**
+ ******************************************************************************
+ * File           : workqueue_test.c
+ * Author         : Ibrahim Diab
+ * Compiler		  : GCC , C99
+ * Target		  : Linux host (POSIX port)
+ * Brief          : Work queue: invalid and full paths, a pending work item
+ *                  coalesced with its next posts, FIFO order across the wrap
+ *                  of the ring indices from tasks and ISRs, a work item
+ *                  posting itself again, and the counters. Built and run by
+ *                  run_tests.sh (WORK_QUEUE, a 4 slots ring and the daemon
+ *                  below the test task).
+ ******************************************************************************
+ */
+
+#include <LIB/std_types.h>
+#include <Kernel/kernel_cfg.h>
+#include <Kernel/WorkQueue.h>
+
+#include "test.h"
+
+
+#if WORK_QUEUE != ENABLED || WORK_QUEUE_PRIORITY != 1
+#error "workqueue_test.c needs WORK_QUEUE with the daemon at priority 1"
+#endif
+
+#define TEST_PRIORITY               2                       // Above the daemon, the posts pile up until the test task waits
+
+#define WORK_ITEMS                  (WORK_QUEUE_LENGTH + 1)
+#define WRAP_ROUNDS                 (3 * WORK_QUEUE_LENGTH + 1)   // Not a multiple of the length
+#define REPOSTS                     3
+
+
+static Work_t Works[WORK_ITEMS];
+static Work_t Repost;
+
+// Work items in the order they ran, by index
+static volatile uint32 Ran[WRAP_ROUNDS * 3];
+static volatile uint32 RanCount, RepostRuns;
+
+
+static void record(void *argument)
+{
+    if (RanCount < sizeof(Ran) / sizeof(Ran[0]))
+        Ran[RanCount] = (uint32)(uintptr_t)argument;
+
+    RanCount++;
+}
+
+// Post itself again while it runs, up to REPOSTS times
+static void repost(void *argument)
+{
+    (void)argument;
+
+    if (++RepostRuns < REPOSTS)
+        (void)os_workPost(&Repost);
+}
+
+
+static void testInvalid(void)
+{
+    check(os_workInit(NULL, &record, NULL) == OS_WORK_INVALID && os_workInit(&Repost, NULL, NULL) == OS_WORK_INVALID,
+          "init without a work item or a function");
+
+    check(os_workPost(NULL) == OS_WORK_INVALID && os_workPostFromISR(NULL) == OS_WORK_INVALID, "post without a work item");
+}
+
+
+static void testFull(void)
+{
+    OS_WorkError_t error;
+    boolean inOrder = TRUE;
+
+    for (uint32 i = 0; i < WORK_QUEUE_LENGTH; i++)
+        (void)os_workPost(&Works[i]);
+
+    error = os_workPost(&Works[WORK_QUEUE_LENGTH]);
+    check(error == OS_WORK_FULL, "post to a full ring: error %d", error);
+
+    error = os_workPost(&Works[0]);
+    check(error == OS_WORK_COALESCED && RanCount == 0, "post of a pending work item coalesced: error %d", error);
+
+    // The daemon runs while the test task waits
+    os_delay(1);
+
+    for (uint32 i = 0; i < WORK_QUEUE_LENGTH; i++)
+    {
+        if (Ran[i] != i)
+            inOrder = FALSE;
+    }
+
+    check(RanCount == WORK_QUEUE_LENGTH && inOrder, "every work item ran once in order, the coalesced one too: %u runs", RanCount);
+
+    // The dropped work item was not left pending
+    check(os_workPost(&Works[WORK_QUEUE_LENGTH]) == OS_WORK_SUCCESS, "work item refused by a full ring posted again");
+    os_delay(1);
+}
+
+
+static void testWrap(void)
+{
+    uint32 next = 0, expected = 0;
+    boolean inOrder = TRUE;
+
+    RanCount = 0;
+
+    // Three posts a round, one from an ISR, the ring indices wrap several times
+    for (uint32 round = 0; round < WRAP_ROUNDS; round++)
+    {
+        for (uint32 i = 0; i < 3; i++)
+        {
+            Works[next % WORK_ITEMS].argument = (void*)(uintptr_t)next;
+
+            if (i == 1)
+                (void)os_workPostFromISR(&Works[next % WORK_ITEMS]);
+            else
+                (void)os_workPost(&Works[next % WORK_ITEMS]);
+
+            next++;
+        }
+
+        os_delay(1);
+    }
+
+    for (uint32 i = 0; i < RanCount; i++)
+    {
+        if (Ran[i] != expected++)
+            inOrder = FALSE;
+    }
+
+    check(RanCount == next && inOrder, "FIFO order of %u work items through a ring of %u: %u runs", next, WORK_QUEUE_LENGTH, RanCount);
+}
+
+
+static void testRepost(void)
+{
+    (void)os_workInit(&Repost, &repost, NULL);
+    (void)os_workPost(&Repost);
+
+    os_delay(1);
+    check(RepostRuns == REPOSTS, "work item posting itself while it runs runs again: %u runs", RepostRuns);
+}
+
+
+static void testStats(void)
+{
+    WorkQueueStats_t stats;
+
+    os_workQueueGetStats(&stats);
+    check(stats.depth == 0 && stats.highWaterMark == WORK_QUEUE_LENGTH && stats.coalesced == 1 && stats.dropped == 1,
+          "counters: depth %u, high water mark %u, coalesced %u, dropped %u",
+          stats.depth, stats.highWaterMark, stats.coalesced, stats.dropped);
+
+    check(stats.posted == stats.executed && stats.posted == WORK_QUEUE_LENGTH + 1 + WRAP_ROUNDS * 3 + REPOSTS,
+          "every posted work item executed: %u posted, %u executed", stats.posted, stats.executed);
+}
+
+
+static void testTask(void)
+{
+    testInvalid();
+    testFull();
+    testWrap();
+    testRepost();
+    testStats();
+
+    finish();
+}
+
+
+int main(void)
+{
+    os_init();
+
+    for (uint32 i = 0; i < WORK_ITEMS; i++)
+        (void)os_workInit(&Works[i], &record, (void*)(uintptr_t)i);
+
+    (void)OS_createTask(NULL, &testTask, "TEST", TEST_PRIORITY, 1024);
+
+    os_start();
+
+    return 0;
+}
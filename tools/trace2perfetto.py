@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""
+ ******************************************************************************
+ * File           : trace2perfetto.py
+ * Author         : Ibrahim Diab
+ * Target         : Host (Python 3)
+ * Brief          : Convert a dump of the kernel trace buffer (TraceBuffer_t,
+ *                  kernel/Inc/Kernel/Trace.h) into a Chrome trace event JSON
+ *                  file, opened by https://ui.perfetto.dev or chrome://tracing.
+ ******************************************************************************
+
+Dump the buffer from the target, for example with GDB:
+    dump binary value trace.bin TraceBuffer
+or from the application with os_traceGetBuffer() and sizeof(TraceBuffer_t).
+
+Usage:
+    trace2perfetto.py trace.bin [-o trace.json]
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+TRACE_MAGIC = 0x31435254
+
+HEADER = struct.Struct("<IHHIIII")
+RECORD = struct.Struct("<IBBH")
+
+TRACE_TASK_SWITCH  = 1
+TRACE_TICK         = 2
+TRACE_TASK_CREATE  = 3
+TRACE_TASK_DELAY   = 4
+TRACE_TASK_SUSPEND = 5
+TRACE_TASK_RESUME  = 6
+TRACE_TASK_DELETE  = 7
+TRACE_ISR_ENTER    = 8
+TRACE_ISR_EXIT     = 9
+
+TASK_EVENTS = {
+    TRACE_TASK_CREATE:  ("create", "priority"),
+    TRACE_TASK_DELAY:   ("delay", "ticks"),
+    TRACE_TASK_SUSPEND: ("suspend", None),
+    TRACE_TASK_RESUME:  ("resume", None),
+    TRACE_TASK_DELETE:  ("delete", None),
+}
+
+PID = 1
+TICK_TID = 999
+ISR_TID_BASE = 1000
+
+
+def parse(dump):
+    """Return the header fields, the task names and the records oldest first."""
+    if len(dump) < HEADER.size:
+        sys.exit("dump too short for a trace header")
+
+    magic, length, name_length, max_tasks, counts_per_tick, tick_us, written = HEADER.unpack_from(dump)
+    if magic != TRACE_MAGIC:
+        sys.exit("bad magic 0x%08x, not a TraceBuffer_t dump" % magic)
+
+    offset = HEADER.size
+    names = []
+    for i in range(max_tasks):
+        raw = dump[offset + i * name_length: offset + (i + 1) * name_length]
+        names.append(raw.split(b"\0", 1)[0].decode("ascii", "replace") or "task %d" % i)
+    offset += max_tasks * name_length
+    offset = (offset + 3) & ~3  # records are 4 bytes aligned
+
+    if len(dump) < offset + length * RECORD.size:
+        sys.exit("dump too short for %d records" % length)
+
+    records = [RECORD.unpack_from(dump, offset + i * RECORD.size) for i in range(length)]
+
+    # The ring wrapped around once more records than its length were written
+    if written <= length:
+        records = records[:written]
+    else:
+        first = written % length
+        records = records[first:] + records[:first]
+
+    return counts_per_tick, tick_us, names, records
+
+
+def convert(counts_per_tick, tick_us, names, records):
+    if counts_per_tick == 0:
+        print("warning: trace started before the tick, counting 1 count per microsecond", file=sys.stderr)
+        counts_per_tick, tick_us = 1, 1
+
+    events = [{"ph": "M", "pid": PID, "name": "process_name", "args": {"name": "RTOS kernel"}},
+              {"ph": "M", "pid": PID, "tid": TICK_TID, "name": "thread_name", "args": {"name": "Tick"}}]
+    for task_id, name in enumerate(names):
+        events.append({"ph": "M", "pid": PID, "tid": task_id + 1, "name": "thread_name",
+                       "args": {"name": "%s (%d)" % (name, task_id)}})
+
+    isr_names = set()
+    running = None
+    now = 0
+    previous = None
+
+    for timestamp, event, task, data in records:
+        # Timestamps wrap around, the records are close enough for a signed 32-bit difference
+        if previous is not None:
+            delta = (timestamp - previous) & 0xFFFFFFFF
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            now += delta
+        previous = timestamp
+        ts = now * tick_us / counts_per_tick
+
+        if event == TRACE_TASK_SWITCH:
+            if running is not None:
+                events.append({"ph": "E", "pid": PID, "tid": running + 1, "ts": ts})
+            events.append({"ph": "B", "pid": PID, "tid": task + 1, "ts": ts, "name": names[task]})
+            running = task
+        elif event == TRACE_TICK:
+            events.append({"ph": "i", "s": "t", "pid": PID, "tid": TICK_TID, "ts": ts,
+                           "name": "tick", "args": {"tick": data}})
+        elif event in TASK_EVENTS:
+            name, arg = TASK_EVENTS[event]
+            events.append({"ph": "i", "s": "t", "pid": PID, "tid": task + 1, "ts": ts, "name": name,
+                           "args": {arg: data} if arg else {}})
+        elif event in (TRACE_ISR_ENTER, TRACE_ISR_EXIT):
+            tid = ISR_TID_BASE + data
+            if data not in isr_names:
+                isr_names.add(data)
+                events.append({"ph": "M", "pid": PID, "tid": tid, "name": "thread_name",
+                               "args": {"name": "ISR %d" % data}})
+            events.append({"ph": "B" if event == TRACE_ISR_ENTER else "E", "pid": PID, "tid": tid,
+                           "ts": ts, "name": "ISR %d" % data})
+        else:
+            print("warning: unknown event %d skipped" % event, file=sys.stderr)
+
+    if running is not None:
+        events.append({"ph": "E", "pid": PID, "tid": running + 1, "ts": now * tick_us / counts_per_tick})
+
+    return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert a kernel trace dump to Chrome/Perfetto JSON")
+    parser.add_argument("dump", help="binary dump of TraceBuffer")
+    parser.add_argument("-o", "--output", default="-", help="output JSON file (default: stdout)")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as dump_file:
+        trace = convert(*parse(dump_file.read()))
+
+    if args.output == "-":
+        json.dump(trace, sys.stdout)
+    else:
+        with open(args.output, "w") as output:
+            json.dump(trace, output)
+
+
+if __name__ == "__main__":
+    main()